@@ -0,0 +1,77 @@
+// 缓冲池并发扩展性测试：多线程 B+ 树点查，比较不同分区数、不同置换器下的吞吐
+// LRU 命中时需持分区锁；CLOCK 的命中走无锁路径
+// 用法: bench_buffer_pool [keys] [lookups_per_thread]
+#include "lightdb/bplus_tree.h"
+#include "lightdb/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* BENCH_INDEX_FILE = "bench_buffer_pool.idx";
+
+    double RunLookups(lightdb::BTreeIndex& index, int num_threads, int num_keys, int lookups_per_thread) {
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < num_threads; t++) {
+            workers.emplace_back([&index, t, num_keys, lookups_per_thread]() {
+                std::mt19937 rng(t + 1);
+                std::uniform_int_distribution<int> dist(0, num_keys - 1);
+                lightdb::RID rid;
+                for (int i = 0; i < lookups_per_thread; i++) {
+                    index.Search(dist(rng), rid);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(num_threads) * lookups_per_thread / elapsed.count();
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::WARN);
+    int num_keys = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int lookups_per_thread = argc > 2 ? std::atoi(argv[2]) : 20000;
+    const int num_frames = 4096; //足够容纳整棵树，测的是命中路径上的锁竞争
+
+    std::printf("keys=%d lookups/thread=%d frames=%d hw_threads=%u\n",
+                num_keys, lookups_per_thread, num_frames, std::thread::hardware_concurrency());
+    std::printf("%-12s", "threads");
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        std::printf("%12d", threads);
+    }
+    std::printf("\n");
+
+    for (auto replacer : {lightdb::ReplacerType::LRU, lightdb::ReplacerType::CLOCK}) {
+        for (int partitions : {1, 4, 16, 64}) {
+            std::remove(BENCH_INDEX_FILE);
+            lightdb::BufferPoolConfig config;
+            config.num_partitions = partitions;
+            config.replacer = replacer;
+            lightdb::BufferPool pool(num_frames, nullptr, config);
+            lightdb::BTreeIndex index(&pool, BENCH_INDEX_FILE, 200);
+            for (int key = 0; key < num_keys; key++) {
+                index.Insert(key, lightdb::RID(0, key));
+            }
+
+            std::string label = (replacer == lightdb::ReplacerType::LRU ? "lru p=" : "clock p=") + std::to_string(partitions);
+            std::printf("%-12s", label.c_str());
+            for (int threads = 1; threads <= 64; threads *= 2) {
+                double ops = RunLookups(index, threads, num_keys, lookups_per_thread);
+                std::printf("%12.0f", ops);
+                std::fflush(stdout);
+            }
+            std::printf("   lookups/sec\n");
+        }
+    }
+    std::remove(BENCH_INDEX_FILE);
+    return 0;
+}
@@ -0,0 +1,109 @@
+// 页压缩：分别以不压缩和 LZ 压缩建同一张表（记录为重复度较高的 ASCII 文本）并刷盘，
+// 比较磁盘占用，再以小缓冲池重新打开（验证页映射重启后可用）做多轮 SeqScan，比较吞吐并校验记录（校验失败时返回 1）
+// 用法: bench_compression [num_records] [pool_frames] [scan_rounds]
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+
+#include <sys/stat.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+    const char* TABLE_FILE = "bench_compression.db";
+
+    std::string MakeRecord(int i) {
+        std::string id = std::to_string(i);
+        return "id=" + id + ",name=user_" + id + ",email=user_" + id + "@example.com,city=Hangzhou,status=active";
+    }
+
+    uint64_t FileSize(const std::string& path) {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+    }
+
+    void RemoveFiles() {
+        std::remove(TABLE_FILE);
+        std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+        std::remove((std::string(TABLE_FILE) + ".pmap").c_str());
+    }
+
+    struct Result {
+        double load_ms;
+        uint64_t data_bytes;
+        uint64_t map_bytes;
+        double scan_mb_per_sec;
+        bool verified;
+    };
+
+    Result Run(lightdb::PageCompression compression, int num_records, int pool_frames, int scan_rounds) {
+        RemoveFiles();
+        Result result{};
+        auto start = std::chrono::steady_clock::now();
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(4096, &dm);
+            lightdb::HeapFile table(TABLE_FILE, &pool, lightdb::StorageMode::BUFFER_POOL, compression);
+            for (int i = 0; i < num_records; i++) {
+                lightdb::Record record;
+                record.data = MakeRecord(i);
+                table.InsertRecord(record);
+            }
+            // pool 析构时写回脏页，dm 析构时持久化页映射
+        }
+        result.load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.data_bytes = FileSize(TABLE_FILE);
+        result.map_bytes = FileSize(std::string(TABLE_FILE) + ".pmap");
+
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(pool_frames, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool, lightdb::StorageMode::BUFFER_POOL, compression);
+        size_t bytes = 0;
+        result.verified = true;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < scan_rounds; r++) {
+            auto records = table.SeqScan();
+            if (records.size() != static_cast<size_t>(num_records)) {
+                result.verified = false;
+            }
+            for (size_t i = 0; i < records.size(); i++) {
+                bytes += records[i].data.size();
+                if (r == 0 && records[i].data != MakeRecord(static_cast<int>(i))) {
+                    result.verified = false;
+                }
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.scan_mb_per_sec = static_cast<double>(bytes) / (1024.0 * 1024.0) / elapsed.count();
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int num_records = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int pool_frames = argc > 2 ? std::atoi(argv[2]) : 64;
+    int scan_rounds = argc > 3 ? std::atoi(argv[3]) : 10;
+
+    std::printf("%d records (e.g. \"%s\"), pool %d frames, %d seq scans\n", num_records, MakeRecord(0).c_str(),
+                pool_frames, scan_rounds);
+    std::printf("%-8s%12s%14s%12s%16s%10s\n", "codec", "load_ms", "data_KB", "map_KB", "SeqScan MB/s", "verified");
+    uint64_t plain_bytes = 0;
+    bool verified = true;
+    for (auto compression : {lightdb::PageCompression::NONE, lightdb::PageCompression::LZ}) {
+        Result result = Run(compression, num_records, pool_frames, scan_rounds);
+        std::printf("%-8s%12.1f%14.1f%12.1f%16.1f%10s\n", compression == lightdb::PageCompression::NONE ? "none" : "lz",
+                    result.load_ms, result.data_bytes / 1024.0, result.map_bytes / 1024.0, result.scan_mb_per_sec,
+                    result.verified ? "yes" : "NO");
+        verified = verified && result.verified;
+        if (compression == lightdb::PageCompression::NONE) {
+            plain_bytes = result.data_bytes;
+        } else if (plain_bytes > 0) {
+            std::printf("on-disk size: %.1f%% of uncompressed (including page map)\n",
+                        100.0 * (result.data_bytes + result.map_bytes) / plain_bytes);
+        }
+    }
+    RemoveFiles();
+    return verified ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// 帧耗尽时的等待：多个线程各自同时 pin 住若干页并持有一小段时间，pin 住的总页数超过缓冲池帧数，
+// 比较 frame_wait_timeout_ms 为 0（无帧可用立即失败）与等待可用帧时的吞吐、失败次数和等待情况
+// 每个线程在 pin 满之前不释放已 pin 的页：帧数不少于 threads * (pins_per_op - 1) + 1 时等待总能结束，
+// 否则可能出现所有线程互相等待，只能靠超时解开
+// 用法: bench_frame_wait [frames] [threads] [pins_per_op] [hold_us] [timeout_ms] 2>/dev/null
+//   每次取页失败都会向 stderr 输出一条错误日志
+#include "lightdb/buffer_pool.h"
+#include "lightdb/logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* BENCH_FILE = "bench_frame_wait.db";
+    const int FILE_PAGES = 4096;
+    const int RUN_MS = 1000;
+
+    void PrepareFile() {
+        std::remove(BENCH_FILE);
+        lightdb::DiskManager dm;
+        lightdb::FileID file_id = dm.OpenFile(BENCH_FILE);
+        std::vector<char> page(lightdb::PAGE_SIZE, 'x');
+        for (int p = 0; p < FILE_PAGES; p++) {
+            lightdb::SetPageChecksum(page.data(), p); //缓冲池读入时会校验
+            dm.WritePage(lightdb::MakePageID(file_id, p), page.data());
+        }
+        dm.SyncFile(file_id);
+    }
+
+    struct Result {
+        double ops_per_sec;
+        uint64_t failed_fetches;
+        lightdb::BufferPoolStats stats;
+    };
+
+    // 每次操作依次 pin 住 pins_per_op 个随机页，持有 hold_us 微秒后全部 unpin；取页失败的操作放弃已 pin 的页
+    Result Run(int frames, int num_threads, int pins_per_op, int hold_us, int timeout_ms) {
+        lightdb::DiskManager dm;
+        lightdb::BufferPoolConfig config;
+        config.frame_wait_timeout_ms = timeout_ms;
+        lightdb::BufferPool pool(frames, &dm, config);
+        lightdb::FileID file_id = dm.OpenFile(BENCH_FILE);
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> ops{0};
+        std::atomic<uint64_t> failed{0};
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < num_threads; t++) {
+            workers.emplace_back([&, t]() {
+                std::mt19937 rng(t + 1);
+                std::uniform_int_distribution<int> page_dist(0, FILE_PAGES - 1);
+                std::vector<lightdb::PageID> pinned;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    pinned.clear();
+                    for (int i = 0; i < pins_per_op; i++) {
+                        lightdb::PageID pid = lightdb::MakePageID(file_id, page_dist(rng));
+                        if (pool.FetchPage(pid) == nullptr) {
+                            failed++;
+                            break;
+                        }
+                        pinned.push_back(pid);
+                    }
+                    if (pinned.size() == static_cast<size_t>(pins_per_op)) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(hold_us));
+                        ops++;
+                    }
+                    for (lightdb::PageID pid : pinned) {
+                        pool.UnpinPage(pid, false);
+                    }
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+        stop = true;
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return {ops / elapsed.count(), failed.load(), pool.GetStats()};
+    }
+
+    void Print(const char* name, const Result& result) {
+        const lightdb::BufferPoolStats& stats = result.stats;
+        std::printf("%-10s%12.0f%10llu%14llu%10llu%16.1f\n", name, result.ops_per_sec,
+                    static_cast<unsigned long long>(result.failed_fetches),
+                    static_cast<unsigned long long>(stats.frame_waits),
+                    static_cast<unsigned long long>(stats.frame_wait_timeouts),
+                    stats.frame_waits == 0 ? 0.0 : stats.frame_wait_nanos / 1000.0 / stats.frame_waits);
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int frames = argc > 1 ? std::atoi(argv[1]) : 56;
+    int num_threads = argc > 2 ? std::atoi(argv[2]) : 16;
+    int pins_per_op = argc > 3 ? std::atoi(argv[3]) : 4;
+    int hold_us = argc > 4 ? std::atoi(argv[4]) : 100;
+    int timeout_ms = argc > 5 ? std::atoi(argv[5]) : 1000;
+    PrepareFile();
+
+    std::printf("%d frames, %d threads each pinning %d pages for %d us (%d pins at peak)\n", frames, num_threads,
+                pins_per_op, hold_us, num_threads * pins_per_op);
+    std::printf("%-10s%12s%10s%14s%10s%16s\n", "mode", "ops/s", "failed", "frame_waits", "timeouts", "avg_wait_us");
+    Print("fail_fast", Run(frames, num_threads, pins_per_op, hold_us, 0));
+    Print("wait", Run(frames, num_threads, pins_per_op, hold_us, timeout_ms));
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,67 @@
+// 堆表按 RID 点查：插入定长小记录后按随机 RID 调用 HeapFile::ReadRecord，缓冲池足以容纳整张表，
+// 测的是页内定位记录的开销（槽数组按 slot_id 直接取槽，与每页记录数无关），
+// 并与不拷贝记录的 ReadRecordRef 比较
+// 用法: bench_heap_read [num_records] [record_size] [reads]
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "bench_heap_read.db";
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int num_records = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int record_size = argc > 2 ? std::atoi(argv[2]) : 32;
+    int reads = argc > 3 ? std::atoi(argv[3]) : 2000000;
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+
+    lightdb::DiskManager dm;
+    lightdb::BufferPool pool(4096, &dm);
+    lightdb::HeapFile table(TABLE_FILE, &pool);
+    std::vector<lightdb::RID> rids;
+    rids.reserve(num_records);
+    for (int i = 0; i < num_records; i++) {
+        lightdb::Record record;
+        record.data = std::string(record_size, static_cast<char>('a' + i % 26));
+        rids.push_back(table.InsertRecord(record));
+    }
+    int per_page = rids.back().slot_id + 1;
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<size_t> dist(0, rids.size() - 1);
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; i++) {
+        bytes += table.ReadRecord(rids[dist(rng)]).data.size();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (bytes != static_cast<size_t>(reads) * record_size) {
+        std::printf("unexpected result: %zu bytes read\n", bytes);
+    }
+    std::printf("%d records of %d bytes (up to %d per page), %d random reads\n", num_records, record_size, per_page,
+                reads);
+    std::printf("ReadRecord avg %.1f ns\n", elapsed.count() / reads);
+
+    bytes = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; i++) {
+        bytes += table.ReadRecordRef(rids[dist(rng)]).GetData().size();
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    if (bytes != static_cast<size_t>(reads) * record_size) {
+        std::printf("unexpected result: %zu bytes referenced\n", bytes);
+    }
+    std::printf("ReadRecordRef avg %.1f ns\n", elapsed.count() / reads);
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+    return 0;
+}
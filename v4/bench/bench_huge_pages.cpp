@@ -0,0 +1,76 @@
+// 大页页内存区：缓冲池容纳全部数据后做随机页访问（类似 B+ 树节点的随机查找），
+// 比较普通页、透明大页、显式大页下的命中吞吐，以及预先缺页对构造时间和首轮访问的影响
+// 用法: bench_huge_pages [frames] [lookups]
+#include "lightdb/buffer_pool.h"
+#include "lightdb/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+    const char* BENCH_FILE = "bench_huge_pages.db";
+
+    double Seconds(std::chrono::steady_clock::time_point start) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    void Run(const char* label, lightdb::HugePageMode mode, bool prefault, int frames, int lookups) {
+        std::remove(BENCH_FILE);
+        lightdb::DiskManager dm;
+        lightdb::FileID file_id = dm.OpenFile(BENCH_FILE);
+        lightdb::BufferPoolConfig config;
+        config.huge_pages = mode;
+        config.prefault_arena = prefault;
+
+        auto start = std::chrono::steady_clock::now();
+        lightdb::BufferPool pool(frames, &dm, config);
+        double construct = Seconds(start);
+
+        // 首轮：每页第一次被读入（文件为空，不产生磁盘读），包含页内存的缺页开销
+        start = std::chrono::steady_clock::now();
+        for (int p = 0; p < frames; p++) {
+            lightdb::PageID pid = lightdb::MakePageID(file_id, p);
+            if (pool.FetchPage(pid) != nullptr) {
+                pool.UnpinPage(pid, false);
+            }
+        }
+        double first_pass = Seconds(start);
+
+        // 随机命中：每次读取页内随机位置的一个字节
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> page_dist(0, frames - 1);
+        std::uniform_int_distribution<int> offset_dist(0, lightdb::PAGE_SIZE - 1);
+        volatile uint64_t sink = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < lookups; i++) {
+            lightdb::PageID pid = lightdb::MakePageID(file_id, page_dist(rng));
+            lightdb::Page* page = pool.FetchPage(pid);
+            if (page == nullptr) {
+                continue;
+            }
+            sink = sink + static_cast<unsigned char>(page->GetData()[offset_dist(rng)]);
+            pool.UnpinPage(pid, false);
+        }
+        double random = Seconds(start);
+        std::printf("%-22s%14.1f%14.1f%16.0f\n", label, construct * 1000, first_pass * 1000, lookups / random);
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int frames = argc > 1 ? std::atoi(argv[1]) : 131072; //512MB
+    int lookups = argc > 2 ? std::atoi(argv[2]) : 2000000;
+
+    std::printf("frames=%d (%d MB) lookups=%d\n", frames, frames / 256, lookups);
+    std::printf("%-22s%14s%14s%16s\n", "arena", "construct ms", "first pass ms", "random hits/s");
+    Run("normal", lightdb::HugePageMode::NONE, false, frames, lookups);
+    Run("normal+prefault", lightdb::HugePageMode::NONE, true, frames, lookups);
+    Run("transparent", lightdb::HugePageMode::TRANSPARENT, false, frames, lookups);
+    Run("transparent+prefault", lightdb::HugePageMode::TRANSPARENT, true, frames, lookups);
+    Run("hugetlb", lightdb::HugePageMode::EXPLICIT, false, frames, lookups);
+    std::remove(BENCH_FILE);
+    return 0;
+}
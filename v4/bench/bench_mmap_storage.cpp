@@ -0,0 +1,98 @@
+// 只读映射存储：先经缓冲池建好一张表和它的 B+ 树索引并刷盘，再分别以 BUFFER_POOL 和
+// MMAP_READ_ONLY 模式通过 Catalog 重新打开，比较 HeapFile::SeqScan 与 BTreeIndex::RangeScan 的吞吐
+// 缓冲池容量小于表文件时 BUFFER_POOL 模式的扫描需要读盘（数据通常已在页缓存中），映射模式只有缺页
+// 用法: bench_mmap_storage [num_records] [pool_frames] [scan_rounds] [range_scans] [range_width]
+#include "lightdb/catalog.h"
+#include "lightdb/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+    const char* TABLE_FILE = "bench_mmap_table.db";
+    const char* INDEX_FILE = "bench_mmap_index.db";
+    const int RECORD_SIZE = 100;
+
+    void PrepareFiles(int num_records) {
+        std::remove(TABLE_FILE);
+        std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+        std::remove(INDEX_FILE);
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(4096, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        lightdb::BTreeIndex index(&pool, INDEX_FILE);
+        for (int i = 0; i < num_records; i++) {
+            lightdb::Record record;
+            record.data = std::string(RECORD_SIZE, static_cast<char>('a' + i % 26));
+            index.Insert(i, table.InsertRecord(record));
+        }
+        // pool 析构时脏页写回磁盘，之后映射才能读到
+    }
+
+    struct Result {
+        double seq_scan_mb_per_sec;
+        double range_scan_per_sec;
+    };
+
+    Result Run(lightdb::StorageMode mode, int pool_frames, int num_records, int scan_rounds,
+               int range_scans, int range_width) {
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(pool_frames, &dm);
+        lightdb::Catalog catalog;
+        lightdb::HeapFile* table = catalog.OpenTable("t", TABLE_FILE, &pool, mode);
+        lightdb::BTreeIndex* index = catalog.OpenIndex("t", "id", INDEX_FILE, &pool, mode);
+
+        size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < scan_rounds; r++) {
+            for (const auto& record : table->SeqScan()) {
+                bytes += record.data.size();
+            }
+        }
+        std::chrono::duration<double> seq_elapsed = std::chrono::steady_clock::now() - start;
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> dist(0, std::max(0, num_records - range_width));
+        size_t hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (int s = 0; s < range_scans; s++) {
+            int low = dist(rng);
+            hits += index->RangeScan(low, low + range_width - 1).size();
+        }
+        std::chrono::duration<double> range_elapsed = std::chrono::steady_clock::now() - start;
+
+        if (bytes != static_cast<size_t>(scan_rounds) * num_records * RECORD_SIZE ||
+            hits != static_cast<size_t>(range_scans) * range_width) {
+            std::printf("unexpected result: %zu bytes scanned, %zu range hits\n", bytes, hits);
+        }
+        return {static_cast<double>(bytes) / (1024.0 * 1024.0) / seq_elapsed.count(),
+                range_scans / range_elapsed.count()};
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int num_records = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int pool_frames = argc > 2 ? std::atoi(argv[2]) : 64;
+    int scan_rounds = argc > 3 ? std::atoi(argv[3]) : 20;
+    int range_scans = argc > 4 ? std::atoi(argv[4]) : 20000;
+    int range_width = argc > 5 ? std::atoi(argv[5]) : 100;
+    PrepareFiles(num_records);
+
+    std::printf("%d records of %d bytes, pool %d frames, %d seq scans, %d range scans of width %d\n",
+                num_records, RECORD_SIZE, pool_frames, scan_rounds, range_scans, range_width);
+    std::printf("%-12s%16s%18s\n", "mode", "SeqScan MB/s", "RangeScan ops/s");
+    for (auto mode : {lightdb::StorageMode::BUFFER_POOL, lightdb::StorageMode::MMAP_READ_ONLY}) {
+        Result result = Run(mode, pool_frames, num_records, scan_rounds, range_scans, range_width);
+        std::printf("%-12s%16.1f%18.1f\n", mode == lightdb::StorageMode::BUFFER_POOL ? "buffer_pool" : "mmap",
+                    result.seq_scan_mb_per_sec, result.range_scan_per_sec);
+    }
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+    std::remove(INDEX_FILE);
+    return 0;
+}
@@ -0,0 +1,101 @@
+// 命名缓冲池：一个热的 B+ 树索引（点查）与一张大表（随机读记录，模拟批量作业）混合访问
+// 先让两者共用一个池，再经 Catalog 在线把索引分配到专用的小池、表分配到剩余容量的池（总帧数不变），
+// 比较两个阶段的点查延迟和索引池命中率，以及切换后从共享池迁入的页数
+// 用法: bench_named_pools [index_keys] [table_records] [shared_frames] [index_frames] [ops]
+#include "lightdb/catalog.h"
+#include "lightdb/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "bench_pools_table.db";
+    const char* INDEX_FILE = "bench_pools_index.db";
+    const int RECORD_SIZE = 400;
+    const int TABLE_READS_PER_LOOKUP = 4;
+
+    struct PhaseResult {
+        double lookup_avg_us;
+        double ops_per_sec;
+    };
+
+    PhaseResult RunPhase(lightdb::BTreeIndex* index, lightdb::HeapFile* table, const std::vector<lightdb::RID>& rids,
+                         int index_keys, int ops) {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> key_dist(0, index_keys - 1);
+        std::uniform_int_distribution<size_t> rid_dist(0, rids.size() - 1);
+        double lookup_nanos = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ops; i++) {
+            auto lookup_start = std::chrono::steady_clock::now();
+            lightdb::RID rid;
+            index->Search(key_dist(rng), rid);
+            lookup_nanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - lookup_start)
+                                .count();
+            for (int r = 0; r < TABLE_READS_PER_LOOKUP; r++) {
+                table->ReadRecord(rids[rid_dist(rng)]);
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return {lookup_nanos / ops / 1000.0, ops / elapsed.count()};
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int index_keys = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int table_records = argc > 2 ? std::atoi(argv[2]) : 20000;
+    int shared_frames = argc > 3 ? std::atoi(argv[3]) : 1024;
+    int index_frames = argc > 4 ? std::atoi(argv[4]) : 384;
+    int ops = argc > 5 ? std::atoi(argv[5]) : 100000;
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+    std::remove(INDEX_FILE);
+
+    lightdb::DiskManager dm;
+    lightdb::BufferPoolManager pools(&dm);
+    lightdb::BufferPool* shared = pools.CreatePool("shared", shared_frames);
+    lightdb::BufferPool* batch = pools.CreatePool("batch", shared_frames - index_frames);
+    lightdb::BufferPool* oltp = pools.CreatePool("oltp", index_frames);
+    lightdb::Catalog catalog;
+    catalog.SetBufferPoolManager(&pools);
+    lightdb::HeapFile* table = catalog.OpenTable("batch_table", TABLE_FILE, shared);
+    lightdb::BTreeIndex* index = catalog.OpenIndex("hot", "id", INDEX_FILE, shared);
+
+    std::vector<lightdb::RID> rids;
+    for (int i = 0; i < table_records; i++) {
+        lightdb::Record record;
+        record.data = std::string(RECORD_SIZE, static_cast<char>('a' + i % 26));
+        rids.push_back(table->InsertRecord(record));
+    }
+    for (int i = 0; i < index_keys; i++) {
+        index->Insert(i, rids[i % rids.size()]);
+    }
+
+    std::printf("index %d keys, table %d records of %d bytes, %d lookups each followed by %d table reads\n",
+                index_keys, table_records, RECORD_SIZE, ops, TABLE_READS_PER_LOOKUP);
+    std::printf("%-10s%18s%12s%18s%16s\n", "phase", "lookup_avg_us", "ops/s", "index_hit_ratio", "migrated_pages");
+
+    RunPhase(index, table, rids, index_keys, ops); //预热
+    shared->ResetStats();
+    PhaseResult result = RunPhase(index, table, rids, index_keys, ops);
+    std::printf("%-10s%18.2f%12.0f%17s%16s\n", "shared", result.lookup_avg_us, result.ops_per_sec, "-", "-");
+
+    // 在线切换：已缓存的页留在共享池，新池未命中时逐页迁入
+    catalog.AssignIndexPool("hot", "id", "oltp");
+    catalog.AssignTablePool("batch_table", "batch");
+    RunPhase(index, table, rids, index_keys, ops); //迁移与预热
+    uint64_t migrated = oltp->GetStats().migrated_pages + batch->GetStats().migrated_pages;
+    oltp->ResetStats();
+    result = RunPhase(index, table, rids, index_keys, ops);
+    std::printf("%-10s%18.2f%12.0f%16.2f%%%16llu\n", "dedicated", result.lookup_avg_us, result.ops_per_sec,
+                oltp->GetStats().HitRatio() * 100, static_cast<unsigned long long>(migrated));
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+    std::remove(INDEX_FILE);
+    return 0;
+}
@@ -0,0 +1,82 @@
+// 并行全表扫描：同一个带过滤条件的扫描分别用单线程游标和 HeapFile::ParallelScan（1、2、4…个线程）执行，
+// 比较耗时并检查结果与单线程扫描一致（不一致时返回 1）。缓冲池足以容纳整张表，测的是 CPU 上的扫描与过滤，
+// 加速比受机器核数限制
+// 用法: bench_parallel_scan [num_records] [record_size] [max_threads] [morsel_pages]
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "bench_parallel_scan.db";
+
+    // 过滤条件：首字节为 'a' 且记录中出现了 'z'（末字节由 i % 27 决定，约 1/700 的行满足）
+    bool Matches(std::string_view data) {
+        return data[0] == 'a' && data.find('z') != std::string_view::npos;
+    }
+
+    double MillisSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int num_records = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int record_size = argc > 2 ? std::atoi(argv[2]) : 100;
+    int max_threads = argc > 3 ? std::atoi(argv[3]) : 8;
+    int morsel_pages = argc > 4 ? std::atoi(argv[4]) : lightdb::HeapFile::DEFAULT_MORSEL_PAGES;
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+
+    lightdb::DiskManager dm;
+    lightdb::BufferPool pool(65536, &dm);
+    lightdb::HeapFile table(TABLE_FILE, &pool);
+    lightdb::Record record;
+    for (int i = 0; i < num_records; i++) {
+        record.data = std::string(record_size, static_cast<char>('a' + i % 26));
+        record.data.back() = static_cast<char>('a' + i % 27);
+        table.InsertRecord(record);
+    }
+    std::printf("%d records of %d bytes, %d-page morsels, %u hardware threads\n", num_records, record_size,
+                morsel_pages, std::thread::hardware_concurrency());
+    std::printf("%-10s%10s%12s%10s\n", "threads", "rows", "ms", "speedup");
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<lightdb::Record> expected;
+    {
+        lightdb::TableIterator it = table.Scan();
+        lightdb::RecordRef ref;
+        while (it.NextRef(&ref)) {
+            if (Matches(ref.GetData())) {
+                expected.push_back(ref.ToRecord());
+            }
+        }
+    }
+    double serial_ms = MillisSince(start);
+    std::printf("%-10s%10zu%12.1f%10s\n", "cursor", expected.size(), serial_ms, "1.00");
+
+    bool all_same = true;
+    auto predicate = [](const lightdb::RecordRef& ref) { return Matches(ref.GetData()); };
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        start = std::chrono::steady_clock::now();
+        std::vector<lightdb::Record> records = table.ParallelScan(predicate, threads, morsel_pages);
+        double ms = MillisSince(start);
+        bool same = records.size() == expected.size();
+        for (size_t i = 0; same && i < records.size(); i++) {
+            same = records[i].rid == expected[i].rid && records[i].data == expected[i].data;
+        }
+        std::printf("%-10d%10zu%12.1f%10.2f%s\n", threads, records.size(), ms, serial_ms / ms,
+                    same ? "" : "  (result differs from cursor scan)");
+        all_same = all_same && same;
+    }
+
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+    return all_same ? 0 : 1;
+}
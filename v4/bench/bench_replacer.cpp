@@ -0,0 +1,159 @@
+// 置换策略对比：
+//   1. 用 B+ 树点查 + 顺序扫描的页访问序列模拟各策略的命中率
+//   2. 在真实 BufferPool 上测量各策略下每次 FetchPage 的平均开销（扫描使用 BufferAccessStrategy 帧环）
+// 用法: bench_replacer [pool_frames]
+#include "lightdb/bplus_tree.h"
+#include "lightdb/logger.h"
+#include "lightdb/replacer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    using lightdb::PageID;
+    using lightdb::frame_id_t;
+
+    // 模拟的页编号空间：一棵三层 B+ 树和一张堆表
+    const int NUM_INNER = 40;
+    const int NUM_LEAVES = 8000;
+    const int NUM_HEAP_PAGES = 20000;
+    const PageID ROOT_PAGE = 0;
+    const PageID INNER_BASE = 1;
+    const PageID LEAF_BASE = INNER_BASE + NUM_INNER;
+    const PageID HEAP_BASE = LEAF_BASE + NUM_LEAVES;
+
+    struct TraceEntry {
+        PageID page_id;
+        bool is_index;
+    };
+
+    // 点查阶段与全表扫描阶段交替，点查的叶子分布偏斜（近似 80/20）
+    std::vector<TraceEntry> BuildTrace(int rounds, int lookups_per_round) {
+        std::vector<TraceEntry> trace;
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < lookups_per_round; i++) {
+                double x = uniform(rng);
+                int leaf = static_cast<int>(x * x * x * NUM_LEAVES) % NUM_LEAVES;
+                trace.push_back({ROOT_PAGE, true});
+                trace.push_back({INNER_BASE + leaf * NUM_INNER / NUM_LEAVES, true});
+                trace.push_back({LEAF_BASE + leaf, true});
+            }
+            for (int p = 0; p < NUM_HEAP_PAGES; p++) {
+                trace.push_back({HEAP_BASE + p, false});
+            }
+        }
+        return trace;
+    }
+
+    struct SimResult {
+        double index_hit_ratio;
+        double overall_hit_ratio;
+    };
+
+    // tag_scans 为 true 时扫描访问以 SEQUENTIAL 类型告知置换器
+    SimResult Simulate(lightdb::ReplacerType type, size_t frames, const std::vector<TraceEntry>& trace, bool tag_scans) {
+        auto replacer = lightdb::MakeReplacer(type, frames);
+        lightdb::PageTable table(frames);
+        std::vector<PageID> frame_page(frames, lightdb::INVALID_PAGE_ID);
+        size_t used = 0;
+        long index_hits = 0, index_total = 0, hits = 0;
+        auto always = [](frame_id_t) { return true; };
+        for (const auto& access : trace) {
+            frame_id_t fid;
+            bool hit = table.Find(access.page_id, &fid);
+            auto access_type = (tag_scans && !access.is_index) ? lightdb::AccessType::SEQUENTIAL
+                                                                : lightdb::AccessType::NORMAL;
+            if (hit) {
+                replacer->RecordAccess(fid, access_type);
+                hits++;
+            } else {
+                if (used < frames) {
+                    fid = static_cast<frame_id_t>(used++);
+                } else {
+                    replacer->Evict(always, &fid);
+                    table.Erase(frame_page[fid]);
+                }
+                frame_page[fid] = access.page_id;
+                table.Insert(access.page_id, fid);
+                replacer->RecordLoad(fid, access.page_id, access_type);
+            }
+            if (access.is_index) {
+                index_total++;
+                index_hits += hit ? 1 : 0;
+            }
+        }
+        return {static_cast<double>(index_hits) / index_total, static_cast<double>(hits) / trace.size()};
+    }
+
+    // 真实缓冲池：B+ 树点查与按页扫描数据文件交替进行，统计平均每次页访问耗时
+    double MeasureFetchCost(lightdb::ReplacerType type, int frames, int num_keys) {
+        std::remove("bench_replacer.idx");
+        std::remove("bench_replacer.db");
+        lightdb::BufferPoolConfig config;
+        config.replacer = type;
+        lightdb::BufferPool pool(frames, nullptr, config);
+        lightdb::BTreeIndex index(&pool, "bench_replacer.idx", 200);
+        for (int key = 0; key < num_keys; key++) {
+            index.Insert(key, lightdb::RID(0, key));
+        }
+        lightdb::FileID data_file = pool.GetDiskManager()->OpenFile("bench_replacer.db");
+        const int scan_pages = frames * 2;
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> dist(0, num_keys - 1);
+        long accesses = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < 4; round++) {
+            lightdb::RID rid;
+            for (int i = 0; i < 5000; i++) {
+                index.Search(dist(rng), rid);
+            }
+            accesses += 5000L * 3; //三层树，每次点查访问 3 个页
+            lightdb::BufferAccessStrategy strategy(pool);
+            for (int p = 0; p < scan_pages; p++) {
+                PageID pid = lightdb::MakePageID(data_file, p);
+                if (pool.FetchPage(pid, &strategy) != nullptr) {
+                    pool.UnpinPage(pid, false);
+                }
+            }
+            accesses += scan_pages;
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        std::remove("bench_replacer.idx");
+        std::remove("bench_replacer.db");
+        return elapsed.count() / accesses;
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int pool_frames = argc > 1 ? std::atoi(argv[1]) : 1024;
+    const lightdb::ReplacerType types[] = {lightdb::ReplacerType::LRU, lightdb::ReplacerType::CLOCK,
+                                           lightdb::ReplacerType::CLOCK_PRO, lightdb::ReplacerType::TWO_Q};
+
+    auto trace = BuildTrace(5, 20000);
+    std::printf("== simulated hit ratio (%zu accesses, index + scan) ==\n", trace.size());
+    std::printf("%-12s%10s%16s%16s%20s\n", "policy", "frames", "index_hit", "overall_hit", "index_hit(tagged)");
+    for (size_t frames : {static_cast<size_t>(pool_frames), static_cast<size_t>(pool_frames) * 4}) {
+        for (auto type : types) {
+            auto replacer = lightdb::MakeReplacer(type, 1);
+            SimResult r = Simulate(type, frames, trace, false);
+            SimResult tagged = Simulate(type, frames, trace, true);
+            std::printf("%-12s%10zu%15.2f%%%15.2f%%%19.2f%%\n", replacer->Name(), frames,
+                        r.index_hit_ratio * 100, r.overall_hit_ratio * 100, tagged.index_hit_ratio * 100);
+        }
+    }
+
+    std::printf("== real buffer pool, %d frames ==\n", pool_frames);
+    std::printf("%-12s%16s\n", "policy", "ns/page_access");
+    for (auto type : types) {
+        auto replacer = lightdb::MakeReplacer(type, 1);
+        std::printf("%-12s%16.1f\n", replacer->Name(), MeasureFetchCost(type, pool_frames, 100000));
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+// 在线扩缩容：多线程随机读写数据页的同时把缓冲池缩小再扩大，
+// 观察每个阶段的吞吐、命中率和单次访问的最长延迟（缩容不应让查询停顿），以及腾空所需时间
+// 用法: bench_resize [file_pages] [full_frames] [small_frames] [threads] [dirty_percent]
+#include "lightdb/buffer_pool.h"
+#include "lightdb/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* BENCH_FILE = "bench_resize.db";
+    const int PHASE_MS = 1000;
+
+    void PrepareFile(int file_pages) {
+        std::remove(BENCH_FILE);
+        lightdb::DiskManager dm;
+        lightdb::FileID file_id = dm.OpenFile(BENCH_FILE);
+        std::vector<char> page(lightdb::PAGE_SIZE, 'x');
+        for (int p = 0; p < file_pages; p++) {
+            lightdb::SetPageChecksum(page.data(), p); //缓冲池读入时会校验
+            dm.WritePage(lightdb::MakePageID(file_id, p), page.data());
+        }
+        dm.SyncFile(file_id);
+    }
+
+    struct PhaseResult {
+        double ops_per_sec;
+        double hit_ratio;
+        double max_latency_us;
+    };
+
+    // 运行 PHASE_MS 毫秒的随机访问；action 在工作线程启动后于主线程执行（例如 Resize）
+    template <typename Action>
+    PhaseResult RunPhase(lightdb::BufferPool& pool, lightdb::FileID file_id, int file_pages, int num_threads,
+                         int dirty_percent, Action action) {
+        pool.ResetStats();
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> ops{0};
+        std::atomic<uint64_t> max_nanos{0};
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < num_threads; t++) {
+            workers.emplace_back([&, t]() {
+                std::mt19937 rng(t + 1);
+                std::uniform_int_distribution<int> page_dist(0, file_pages - 1);
+                std::uniform_int_distribution<int> percent(0, 99);
+                uint64_t local_ops = 0;
+                uint64_t local_max = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    lightdb::PageID pid = lightdb::MakePageID(file_id, page_dist(rng));
+                    bool dirty = percent(rng) < dirty_percent;
+                    auto op_start = std::chrono::steady_clock::now();
+                    lightdb::Page* page = pool.FetchPage(pid);
+                    if (page != nullptr) {
+                        if (dirty) {
+                            page->GetData()[0] = 'y';
+                        }
+                        pool.UnpinPage(pid, dirty);
+                    }
+                    uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - op_start).count();
+                    local_max = std::max(local_max, nanos);
+                    local_ops++;
+                }
+                ops += local_ops;
+                uint64_t prev = max_nanos.load();
+                while (local_max > prev && !max_nanos.compare_exchange_weak(prev, local_max)) {
+                }
+            });
+        }
+        action();
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(PHASE_MS));
+        stop = true;
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return {ops / elapsed.count(), pool.GetStats().HitRatio(), max_nanos / 1000.0};
+    }
+
+    void PrintPhase(const char* name, int frames, const PhaseResult& result) {
+        std::printf("%-14s%10d%14.0f%12.2f%%%16.1f\n", name, frames, result.ops_per_sec, result.hit_ratio * 100,
+                    result.max_latency_us);
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int file_pages = argc > 1 ? std::atoi(argv[1]) : 8192;
+    int full_frames = argc > 2 ? std::atoi(argv[2]) : 8192;
+    int small_frames = argc > 3 ? std::atoi(argv[3]) : 2048;
+    int num_threads = argc > 4 ? std::atoi(argv[4]) : 4;
+    int dirty_percent = argc > 5 ? std::atoi(argv[5]) : 10;
+    PrepareFile(file_pages);
+
+    lightdb::DiskManager dm;
+    lightdb::BufferPoolConfig config;
+    config.num_partitions = 8;
+    config.replacer = lightdb::ReplacerType::CLOCK;
+    config.max_pool_frames = full_frames;
+    lightdb::BufferPool pool(full_frames, &dm, config);
+    lightdb::FileID file_id = dm.OpenFile(BENCH_FILE);
+
+    std::printf("file %d pages, %d threads, %d%% writes, %d ms per phase\n", file_pages, num_threads, dirty_percent,
+                PHASE_MS);
+    std::printf("%-14s%10s%14s%13s%16s\n", "phase", "frames", "ops/s", "hit_ratio", "max_latency_us");
+    PrintPhase("warm", full_frames, RunPhase(pool, file_id, file_pages, num_threads, dirty_percent, []() {}));
+    PrintPhase("steady", full_frames, RunPhase(pool, file_id, file_pages, num_threads, dirty_percent, []() {}));
+
+    double drain_ms = 0;
+    PrintPhase("shrink", small_frames, RunPhase(pool, file_id, file_pages, num_threads, dirty_percent, [&]() {
+        auto start = std::chrono::steady_clock::now();
+        pool.Resize(small_frames);
+        pool.WaitForResize();
+        drain_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }));
+    PrintPhase("small", small_frames, RunPhase(pool, file_id, file_pages, num_threads, dirty_percent, []() {}));
+    PrintPhase("grow", full_frames, RunPhase(pool, file_id, file_pages, num_threads, dirty_percent, [&]() {
+        pool.Resize(full_frames);
+    }));
+    PrintPhase("regrown", full_frames, RunPhase(pool, file_id, file_pages, num_threads, dirty_percent, []() {}));
+    std::printf("shrink %d -> %d frames drained in %.1f ms\n", full_frames, small_frames, drain_ms);
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// 表扫描游标：比较 HeapFile::SeqScan（整表拷贝进 vector 后返回）与 HeapFile::Scan 游标逐条取记录的
+// 全表扫描吞吐、取到第一条记录的延迟和常驻内存增量，以及只取前 limit 条（LIMIT 查询）时的耗时
+// 游标只 pin 住当前一批页，内存占用与表的大小无关；最后比较带过滤条件的扫描中 Next（每条记录都拷贝）
+// 与 NextRef（原地检查，只拷贝满足条件的行）的耗时
+// 用法: bench_table_scan [num_records] [record_size] [limit] [pool_frames]
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "bench_table_scan.db";
+
+    long MaxRssKB() {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    double MillisSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    int num_records = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int record_size = argc > 2 ? std::atoi(argv[2]) : 100;
+    int limit = argc > 3 ? std::atoi(argv[3]) : 10;
+    int pool_frames = argc > 4 ? std::atoi(argv[4]) : 1024;
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+
+    lightdb::DiskManager dm;
+    lightdb::BufferPool pool(pool_frames, &dm);
+    lightdb::HeapFile table(TABLE_FILE, &pool);
+    lightdb::Record record;
+    for (int i = 0; i < num_records; i++) {
+        record.data = std::string(record_size, static_cast<char>('a' + i % 26));
+        table.InsertRecord(record);
+    }
+    double table_mb = static_cast<double>(num_records) * record_size / (1 << 20);
+    std::printf("%d records of %d bytes (%.1f MB of data), pool %d frames\n", num_records, record_size, table_mb,
+                pool_frames);
+    std::printf("%-12s%12s%16s%14s%14s\n", "mode", "records", "first_row_ms", "total_ms", "rss_delta_MB");
+
+    // 游标先跑：最大常驻内存只增不减，SeqScan 在后面才能看出它自己的增量
+    long rss_before = MaxRssKB();
+    auto start = std::chrono::steady_clock::now();
+    double first_row_ms = 0;
+    size_t count = 0;
+    lightdb::TableIterator it = table.Scan();
+    while (it.Next(&record)) {
+        if (count++ == 0) {
+            first_row_ms = MillisSince(start);
+        }
+    }
+    std::printf("%-12s%12zu%16.3f%14.1f%14.1f\n", "Scan", count, first_row_ms, MillisSince(start),
+                (MaxRssKB() - rss_before) / 1024.0);
+
+    start = std::chrono::steady_clock::now();
+    count = 0;
+    {
+        lightdb::TableIterator limited = table.Scan();
+        while (count < static_cast<size_t>(limit) && limited.Next(&record)) {
+            count++;
+        }
+    }
+    double limit_ms = MillisSince(start);
+    std::printf("%-12s%12zu%16.3f%14.3f%14s\n", "Scan+limit", count, limit_ms, limit_ms, "-");
+
+    rss_before = MaxRssKB();
+    start = std::chrono::steady_clock::now();
+    std::vector<lightdb::Record> records = table.SeqScan();
+    double total_ms = MillisSince(start);
+    std::printf("%-12s%12zu%16.1f%14.1f%14.1f\n", "SeqScan", records.size(), total_ms, total_ms,
+                (MaxRssKB() - rss_before) / 1024.0);
+
+    records.clear();
+    records.shrink_to_fit();
+
+    // 过滤条件：首字节为 'a'，约 1/26 的行满足
+    start = std::chrono::steady_clock::now();
+    size_t kept = 0;
+    {
+        lightdb::TableIterator filtered = table.Scan();
+        while (filtered.Next(&record)) {
+            if (record.data[0] == 'a') {
+                records.push_back(record);
+            }
+        }
+        kept = records.size();
+    }
+    double copy_ms = MillisSince(start);
+    records.clear();
+    start = std::chrono::steady_clock::now();
+    {
+        lightdb::TableIterator filtered = table.Scan();
+        lightdb::RecordRef ref;
+        while (filtered.NextRef(&ref)) {
+            if (ref.GetData()[0] == 'a') {
+                records.push_back(ref.ToRecord());
+            }
+        }
+    }
+    std::printf("filter keeping %zu rows: Next %.1f ms, NextRef %.1f ms\n", kept, copy_ms, MillisSince(start));
+    if (records.size() != kept) {
+        std::printf("unexpected result: NextRef kept %zu rows\n", records.size());
+    }
+
+    std::remove(TABLE_FILE);
+    std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+    return 0;
+}
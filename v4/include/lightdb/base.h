@@ -10,6 +10,20 @@ namespace lightdb {
     using PageID = int32_t;
     const PageID INVALID_PAGE_ID = -1; //invalid page 
     const int PAGE_SIZE = 4096;
+
+    // PageID 编码：高位为文件编号(FileID)，低 PAGE_NO_BITS 位为文件内页号
+    using FileID = int32_t;
+    const FileID INVALID_FILE_ID = -1;
+    const int PAGE_NO_BITS = 24;
+    inline PageID MakePageID(FileID file_id, int32_t page_no) {
+        return (file_id << PAGE_NO_BITS) | page_no;
+    }
+    inline FileID GetFileID(PageID page_id) {
+        return page_id >> PAGE_NO_BITS;
+    }
+    inline int32_t GetPageNo(PageID page_id) {
+        return page_id & ((1 << PAGE_NO_BITS) - 1);
+    }
     struct RID {
         PageID page_id;
         int slot_id; //index position in page record
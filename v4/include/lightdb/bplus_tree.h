@@ -4,9 +4,11 @@
 #include "base.h"
 #include "buffer_pool.h"
 #include "page.h"
+#include "mmap_file.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <shared_mutex>
 
 namespace lightdb {
 
@@ -53,38 +55,61 @@ struct BTreeInternalNode : BTreeNode {
     void Deserialize(const char* data) override;
 };
 
+// 索引文件第 0 页为元数据页，记录根节点所在的页号，文件重新打开或被映射读取时据此找到根
+struct BTreeMeta {
+    uint32_t magic;
+    int32_t root_page_no;
+};
+
 class BTreeIndex {
 private:
+    static const uint32_t META_MAGIC = 0x4C425449;  // "LBTI"
+    static const int32_t META_PAGE_NO = 0;
+
     BufferPool* buffer_pool_;
+    std::shared_mutex pool_latch_;  // 每个操作持共享锁，切换缓冲池时持排他锁
+    FileID file_id_;
     PageID root_page_id_;
     int order_;  // 阶数：每个节点最多order_-1个关键字
-    PageID next_page_id_;  // 用于分配新页ID
+    int32_t next_page_id_;  // 用于分配新页ID（文件内页号）
+    StorageMode mode_;
+    PageCompression compression_;
+    std::unique_ptr<MmapFile> mmap_file_;  // 仅 MMAP_READ_ONLY 模式
+
+    static const size_t RANGE_SCAN_BATCH = 16;  // RangeScan 每批最多读取的叶子数
 
     // 辅助函数
     std::unique_ptr<BTreeNode> FetchNode(PageID pid);
+    // 批量读取节点，缓冲池模式下整批只加一次分区锁、未命中的页一次读入；读取失败的位置为 nullptr
+    std::vector<std::unique_ptr<BTreeNode>> FetchNodes(const std::vector<PageID>& pids);
+    static std::unique_ptr<BTreeNode> DecodeNode(PageID pid, const char* data);
     void SaveNode(const BTreeNode* node);
+    bool LoadMeta();
+    void SaveMeta();
     PageID AllocatePage();
     bool InsertHelper(PageID pid, const KeyType& key, const ValueType& value, KeyType& split_key, PageID& new_page_id);
     bool DeleteHelper(PageID pid, const KeyType& key);
     void SplitLeafNode(const BTreeLeafNode* leaf, BTreeLeafNode* new_leaf, KeyType& split_key);
     void SplitInternalNode(const BTreeInternalNode* internal, BTreeInternalNode* new_internal, KeyType& split_key);
-    PageID FindFirstLeaf(const KeyType& key);
+    // next_leaves 非空时填入该叶子在父节点中之后的兄弟叶子（按键序），RangeScan 据此成批读取
+    PageID FindFirstLeaf(const KeyType& key, std::vector<PageID>* next_leaves = nullptr);
 
 public:
-    BTreeIndex(BufferPool* bp, int order = 100)
-        : buffer_pool_(bp), root_page_id_(INVALID_PAGE_ID), order_(order), next_page_id_(0) {
-        // 初始化根节点（如果是新树）
-        if (root_page_id_ == INVALID_PAGE_ID) {
-            root_page_id_ = AllocatePage();
-            auto root = std::make_unique<BTreeLeafNode>(root_page_id_);
-            SaveNode(root.get());
-        }
-    }
+    // 已有索引文件时从元数据页恢复根节点，否则创建一棵空树
+    // MMAP_READ_ONLY 模式下文件只读映射，节点读取不经过缓冲池，插入和删除会失败
+    // 压缩的索引文件无法映射，此时退回 BUFFER_POOL 模式
+    BTreeIndex(BufferPool* bp, const std::string& file_path, int order = 100,
+               StorageMode mode = StorageMode::BUFFER_POOL, PageCompression compression = PageCompression::NONE);
 
     bool Insert(const KeyType& key, const ValueType& value);
     bool Search(const KeyType& key, ValueType& value);
     bool Delete(const KeyType& key);
     std::vector<ValueType> RangeScan(const KeyType& start, const KeyType& end);
+    StorageMode GetStorageMode() const { return mode_; }
+    PageCompression GetCompression() const { return compression_; }
+    // 在线改由另一个缓冲池（须共用同一 DiskManager）服务本索引，已缓存的节点页在新池访问到时才从旧池迁入
+    bool SetBufferPool(BufferPool* bp);
+    BufferPool* GetBufferPool();
 };
 
 } // namespace lightdb
@@ -2,33 +2,302 @@
 #define LIGHTDB_BUFFER_POOL_H
 #include "base.h"
 #include "lightdb/page.h"
+#include "lightdb/page_guard.h"
 #include "lightdb/logger.h"
-#include <unordered_map>
-#include <list> 
+#include "lightdb/disk_manager.h"
+#include "lightdb/page_table.h"
+#include "lightdb/replacer.h"
+#include "lightdb/memory_arena.h"
+#include "lightdb/buffer_pool_stats.h"
+#include "lightdb/checksum.h"
+#include <vector>
+#include <memory>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <shared_mutex>
+#include <unordered_set>
 namespace lightdb {
-    struct Frame {
+    const size_t CACHE_LINE_SIZE = 64;
+
+    // 帧描述符按缓存行对齐，相邻帧的元数据不会落在同一缓存行上；页数据在单独的页内存区中
+    // pin_count 为原子量：命中路径不加锁，用 CAS 在 pin_count >= 0 时加一；
+    // 淘汰、复用或写出帧的线程（持有分区锁）用 CAS 把 0 改为 FRAME_CLAIMED 独占该帧，期间无法被 pin
+    struct alignas(CACHE_LINE_SIZE) Frame {
+        static const int FRAME_CLAIMED = -1;
+
         Page page;
-        bool is_dirty;
-        int pin_count; 
-        std::list<PageID>::iterator lru_iter;
+        std::atomic<bool> is_dirty{false};
+        std::atomic<int> pin_count{0};
+        bool write_in_progress = false; //后台写线程、腾空或 FlushAll 正在写出该页的副本，期间不能淘汰（受分区锁保护）
+        bool retired = false; //缩容后已停用：不在页表、空闲链表和置换器中（受分区锁保护）
+        std::atomic<bool> read_in_progress{false}; //预读的异步读尚未完成，期间不能访问或淘汰
+
+        bool TryPin() {
+            int pins = pin_count.load(std::memory_order_relaxed);
+            while (pins >= 0) {
+                if (pin_count.compare_exchange_weak(pins, pins + 1, std::memory_order_acquire)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        bool TryClaim() {
+            int expected = 0;
+            return pin_count.compare_exchange_strong(expected, FRAME_CLAIMED, std::memory_order_acquire);
+        }
+    };
+
+    struct BufferPoolConfig {
+        int num_partitions = 1; //按 PageID 哈希分区，每个分区独立加锁
+        ReplacerType replacer = ReplacerType::LRU; //每个分区各自持有一个该类型的置换器
+        IOEngineType io_engine = IOEngineType::SYNC; //缓冲池自行创建 DiskManager 时使用的 I/O 引擎
+
+        // 页校验和：写盘前总是填入页尾的 CRC32C，读盘后按此方式校验；带 BufferAccessStrategy 的读取可单独指定
+        ChecksumVerify verify_checksums = ChecksumVerify::ALWAYS;
+
+        // 在线扩缩容：帧描述符、页表、置换器和页内存区的虚拟地址按上限一次性保留，物理内存只随可用帧分配
+        int max_pool_frames = 0; //Resize 的上限，不大于构造时的帧数时不能扩容
+        int resize_drain_batch = 64; //缩容时每轮在所有分区中最多停用/写出的帧数
+        int resize_drain_interval_ms = 1; //缩容的腾空线程每轮之间的休眠时间
+
+        // 页内存区：所有帧的页数据在一整块匿名映射中，尽量使用 2MB 大页，减少随机访问 B+ 树节点时的 TLB 未命中
+        HugePageMode huge_pages = HugePageMode::TRANSPARENT;
+        bool prefault_arena = false; //构造时预先触碰可用帧的内存，首批查询不再承担缺页开销
+
+        // 后台写线程：周期性地把置换器冷端的脏页写回磁盘，使前台未命中时尽量找到干净的淘汰帧
+        bool background_writer = false;
+        int bg_writer_interval_ms = 100; //每轮之间的休眠时间
+        int bg_writer_max_pages_per_sec = 2000; //I/O 预算，每轮最多写 max_pages_per_sec * interval 页
+        int bg_writer_scan_depth = 64; //每轮在每个分区冷端检查的帧数
+
+        // 顺序预读：带 BufferAccessStrategy 的扫描开启预读后，连续访问时异步读入后续页
+        int read_ahead_initial_pages = 4; //初始窗口
+        int read_ahead_max_pages = 64; //窗口上限（256KB）
+
+        // 无帧可淘汰（所有帧都被 pin 住或有 I/O 在途）时，FetchPage 在分区上等待帧被 unpin 或释放，
+        // 而不是立即失败；超时后返回 nullptr。0 表示不等待，负数表示一直等待
+        // 等待期间调用方自己持有的 pin 不会释放，一个线程 pin 住整个分区后再取页只能等到超时
+        int frame_wait_timeout_ms = 1000;
+    };
+
+    class BufferPool;
+
+    // 缓冲区访问策略（参考 PostgreSQL 的 BAS_BULKREAD）
+    // 顺序扫描持有一个小的帧环，未命中时循环复用环中自己读入的帧，
+    // 不会把整个缓冲池中的热页（如 B+ 树内部节点）冲刷掉。一个策略对象只供一个扫描使用
+    class BufferAccessStrategy {
+        public:
+            static const int DEFAULT_RING_PAGES = 32; //256KB，与 PostgreSQL 相同
+            explicit BufferAccessStrategy(const BufferPool& pool, int ring_pages = DEFAULT_RING_PAGES);
+
+            // 提示将顺序读取 file_id 中 [0, end_page_no) 的页，开启预读；帧环随之扩大以容纳预读窗口
+            void EnableReadAhead(FileID file_id, int32_t end_page_no);
+            // 本次扫描读盘时的校验方式，默认与缓冲池配置相同
+            void SetChecksumVerify(ChecksumVerify verify) { verify_ = verify; }
+        private:
+            friend class BufferPool;
+            struct Ring {
+                std::vector<PageID> pages;
+                size_t cursor = 0;
+            };
+            // 预读状态：窗口随消费速度自适应——消费者追上在途读时加倍，预读页未被使用就被换出时减半
+            struct ReadAhead {
+                bool enabled = false;
+                FileID file_id = INVALID_FILE_ID;
+                int32_t end_page_no = 0;
+                int32_t last_page_no = -1; //上一次访问的页号
+                int32_t next_page_no = 0; //下一个尚未预读的页号
+                int window = 0;
+                int initial_window = 0;
+                int max_window = 0;
+            };
+            std::vector<Ring> rings_; //每个分区一个环
+            int max_ring_per_partition_;
+            ReadAhead read_ahead_;
+            ChecksumVerify verify_;
     };
+
     class BufferPool {
         public:
-            explicit BufferPool(int max_frames = 32) :
-                max_frames(max_frames) {}
-            ~BufferPool() = default;
+            // disk_manager 为空时缓冲池自行创建并持有一个 DiskManager
+            // 所有帧在构造时一次性分配，运行期间 FetchPage 返回的 Page* 地址保持不变；
+            // 页数据按页对齐，整块注册给 I/O 引擎，批量 I/O 与 O_DIRECT 直接读写帧内存
+            explicit BufferPool(int max_frames = 32, DiskManager* disk_manager = nullptr,
+                                const BufferPoolConfig& config = BufferPoolConfig());
+            ~BufferPool(); //析构时停止后台写线程并将脏页写回磁盘
 
-            Page* FetchPage(PageID page_id);
+            // 所有帧都被 pin 住时返回 nullptr
+            // 置换器支持并发记录访问（CLOCK）时，命中路径只做无锁页表查找和 CAS pin，不获取任何锁
+            // 传入 strategy 表示顺序访问：置换器不把页面视为热页，未命中时优先复用策略环中的帧
+            // strategy 开启了预读时，连续访问会触发对后续页的异步预读
+            Page* FetchPage(PageID page_id, BufferAccessStrategy* strategy = nullptr);
+            // 取得页面并加读闩/写闩，返回的守卫析构时自动解闩并 unpin；所有帧都被 pin 住时返回无效守卫
+            // FetchPage/UnpinPage 不加闩，仅供自行管理并发的调用方使用
+            ReadPageGuard FetchPageRead(PageID page_id, BufferAccessStrategy* strategy = nullptr);
+            WritePageGuard FetchPageWrite(PageID page_id, BufferAccessStrategy* strategy = nullptr);
+            // 批量取页：按分区分组，每个分区只加一次锁完成查找、pin 命中页和为未命中页分配帧，
+            // 未命中的页在锁外作为一批读入（io_uring 下一次提交），读完后每个分区再加一次锁完成登记
+            // 返回与 page_ids 一一对应、已 pin 住的 Page*，无帧可用或读失败的页为 nullptr；
+            // 一批页同时占用帧，批的大小应远小于缓冲池（或策略环）的帧数
+            std::vector<Page*> FetchPages(const std::vector<PageID>& page_ids, BufferAccessStrategy* strategy = nullptr);
+            // 批量取页并逐页加读闩，无效守卫对应取页失败的页
+            std::vector<ReadPageGuard> FetchPagesRead(const std::vector<PageID>& page_ids,
+                                                      BufferAccessStrategy* strategy = nullptr);
+            // 异步预读：为尚不在缓冲池中的页分配帧并整批提交读请求，不等待完成即返回
+            void PrefetchPages(const std::vector<PageID>& page_ids, BufferAccessStrategy* strategy = nullptr);
             void UnpinPage(PageID page_id, bool is_dirty); //release page pin
+            // 在页的读闩下拷贝出副本后写盘，调用方不能持有该页的写闩
             void FlushPage(PageID  page_id);
+            // 写回所有脏页（关闭或检查点时使用）：收集脏页并按 PageID 排序，逐批拷贝出来在锁外写盘，
+            // 同一文件的相邻页合并为一次大的写（同步引擎下为 pwritev）；sync_files 为 true 时
+            // 写完后对涉及的每个文件只 fdatasync 一次。可与访问并发，期间新弄脏的页留给下一次刷盘
+            // 返回是否全部写成功，写失败的页保持为脏页
+            bool FlushAll(bool sync_files = true);
+            DiskManager* GetDiskManager() { return disk_manager_; }
+            int GetNumPartitions() const { return static_cast<int>(partitions_.size()); }
+            int GetMaxFrames() const { return max_frames.load(std::memory_order_relaxed); } //当前的目标帧数
+            int GetCapacityFrames() const { return capacity_frames_; } //Resize 的上限
+
+            // 在线调整帧数，new_frames 取 [分区数, GetCapacityFrames()]，超出范围时返回 false
+            // 扩容立即生效；缩容时空闲帧立即停用，持有页面的帧由后台腾空线程逐批处理：
+            // 干净的未 pin 帧直接淘汰，脏页先在锁外写回再淘汰，被 pin 住的帧等待下一轮。
+            // 前台未命中淘汰到待停用的帧时也会顺带停用它。全部停用后归还这些帧的物理内存
+            bool Resize(int new_frames);
+            bool IsResizing() const { return draining_.load(std::memory_order_acquire); }
+            void WaitForResize(); //等待缩容的腾空完成
+            const BufferPoolConfig& GetConfig() const { return config_; }
+            // 统计：按分区累计命中、未命中、淘汰、刷盘、锁等待等，计数器为 relaxed 原子量，不影响命中路径的并发
+            BufferPoolStats GetStats() const; //所有分区的合计
+            BufferPoolStats GetPartitionStats(int part_idx) const;
+            void ResetStats();
+            const char* GetReplacerName() const { return partitions_[0]->replacer->Name(); }
+
+            // 多个缓冲池共用一个 DiskManager 时（见 BufferPoolManager），文件可以在线改由另一个池服务
+            void AddPeer(BufferPool* peer); //peer 为共用同一 DiskManager 的另一个缓冲池
+            // 文件改由本池服务（原先由 from 服务）：此后本池未命中该文件的页时，先从 peer 中取走该页
+            // （连同脏标记，不经过磁盘），取不到才读盘，页面随访问逐步迁入；其他池不再对该文件这样做
+            // from 须为本池或其 peer，否则返回 false；调用方须保证切换时没有经 from 访问该文件的操作
+            bool AdoptFile(FileID file_id, BufferPool* from);
         private:
-            void UpdateLRU(PageID page_id);
-            void EvictLRU(); //淘汰页尾
-            int max_frames;
-            std::unordered_map<PageID, Frame> frame_map_;
-            std::list<PageID> lru_list_; 
-            std::mutex mutex_;
+            // 分区：拥有一组帧，以及这些帧的页表、置换器和锁
+            // 页表、空闲链表和置换器中使用分区内的局部帧号，frames 将局部帧号映射到全局帧数组下标
+            struct alignas(CACHE_LINE_SIZE) Partition {
+                Partition(size_t num_frames, ReplacerType type)
+                    : page_table(num_frames), replacer(MakeReplacer(type, num_frames)),
+                      lock_free_hits(replacer->IsAccessThreadSafe()) {}
+                std::mutex mutex;
+                PageTable page_table;
+                std::vector<frame_id_t> frames;
+                std::vector<frame_id_t> free_list; //空闲帧
+                std::unique_ptr<Replacer> replacer;
+                bool lock_free_hits; //命中时是否可以不加锁
+                std::condition_variable io_done; //后台写或预读完成、帧被释放时通知等待的线程
+                std::atomic<int> frame_waiters{0}; //等待可用帧的线程数，非 0 时 unpin 到 0 需加锁通知 io_done
+                int reads_in_flight = 0; //本分区尚未完成的预读数
+                frame_id_t num_active = 0; //局部帧号小于它的帧可用，其余帧待停用或已停用
+                size_t num_retiring = 0; //超出 num_active 但仍持有页面的帧数
+                PartitionStats stats;
+            };
+            size_t GetPartitionIndex(PageID page_id) const;
+            Partition& GetPartition(PageID page_id) { return *partitions_[GetPartitionIndex(page_id)]; }
+            Frame& GetFrame(Partition& part, frame_id_t local_id) { return frames_[part.frames[local_id]]; }
+            // 获取分区锁并记录等待时间；先 try_lock，只有发生竞争时才读时钟
+            std::unique_lock<std::mutex> LockPartition(Partition& part);
+            enum class CopyResult { COPIED, CLEAN, LATCH_BUSY };
+            // 为写盘拷贝页面：pin 住帧后释放分区锁，加页的读闩，等待该页在途的写完成后清除脏标记、标记为写出中，
+            // 在读闩下拷贝到 dest 并填入校验和，不会拷贝到持有写闩的线程修改到一半的页
+            // wait_latch 为 false 时页正被写闩住则不等待，返回 LATCH_BUSY
+            // 调用方持有分区锁，帧中的页已读完；返回时仍持有锁，COPIED 时须写盘后调用 FinishWrite
+            CopyResult CopyForWrite(Partition& part, std::unique_lock<std::mutex>& lock, Frame& frame, char* dest,
+                                    bool wait_latch);
+            void FinishWrite(Partition& part, Frame& frame, PageID page_id, bool ok); //调用方持有分区锁
+            // 写盘前填入校验和；写成功后记入最近写出表
+            void StampChecksum(PageID page_id, char* data) { SetPageChecksum(data, GetPageNo(page_id)); }
+            void RememberWrite(PageID page_id);
+            bool VerifyRead(Partition& part, PageID page_id, const char* data, ChecksumVerify verify);
+            void SetActiveFrames(Partition& part, frame_id_t num_active); //调用方需持有分区锁
+            void ReleaseFrame(Partition& part, frame_id_t local_id); //归还未使用的帧：放回空闲链表或直接停用
+            void RegisterFrames(int num_frames); //把前 num_frames 帧的页内存注册给 I/O 引擎，调用方需持有 resize_mutex_
+            void ResizeDrainLoop();
+            size_t DrainRound(size_t budget); //返回仍待停用的帧数
+            // 淘汰时选中的脏页：在分区锁内独占该帧拷贝出副本并标记为写出中，由调用方释放分区锁后写盘，
+            // 写盘期间页仍留在缓冲池中可以被命中，写完后帧变干净，下一次分配即可淘汰它
+            struct VictimWrite {
+                PageID page_id = INVALID_PAGE_ID;
+                frame_id_t fid = INVALID_FRAME_ID;
+                std::vector<char> data;
+                bool Pending() const { return page_id != INVALID_PAGE_ID; }
+            };
+            void TakeVictim(Partition& part, frame_id_t fid, VictimWrite* victim); //调用方持有分区锁并已独占该帧
+            // 释放分区锁写出 victim，返回时重新持有锁；调用方须重新查页表再分配
+            void WriteVictim(Partition& part, std::unique_lock<std::mutex>& lock, VictimWrite* victim);
+            // 以下三个只淘汰干净的页；遇到脏页时若 victim 非空且尚未选中，把第一个脏页交给 victim 写出
+            frame_id_t EvictFrame(Partition& part, VictimWrite* victim); //由置换器选出淘汰帧，返回腾出的局部帧号
+            frame_id_t TakeRingFrame(Partition& part, BufferAccessStrategy::Ring& ring,
+                                     VictimWrite* victim); //复用策略环中最老的帧
+            frame_id_t AllocateFrame(Partition& part, size_t part_idx, BufferAccessStrategy* strategy,
+                                     VictimWrite* victim); //返回的帧已被独占
+            // 无帧可分配时按 frame_wait_timeout_ms 等待：先登记为等待者再重试分配（与 unpin 配对，不会漏掉唤醒），
+            // 仍失败且没有选中脏页时在 io_done 上等待直到被唤醒或到达截止时间；返回 false 表示已超时
+            // 唤醒后页可能已被他人读入，调用方须重新查页表再分配
+            // 重试分配到的帧经 fid 返回（否则为 INVALID_FRAME_ID）
+            bool WaitForFrame(Partition& part, size_t part_idx, BufferAccessStrategy* strategy,
+                              std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point deadline,
+                              frame_id_t* fid, VictimWrite* victim);
+            Frame* TryPinLockFree(Partition& part, PageID page_id, AccessType access_type); //无锁命中路径
+            Page* FetchPageImpl(PageID page_id, BufferAccessStrategy* strategy, bool* hit, bool* waited);
+            void ReadAheadAfter(PageID page_id, BufferAccessStrategy& strategy, bool hit, bool waited);
+            void CompletePrefetch(PageID page_id, bool ok, ChecksumVerify verify); //预读完成回调
+            bool IsMigrating(FileID file_id);
+            void StopMigrating(FileID file_id);
+            // 载入未命中的页：帧像预读一样先登记为读进行中，在不持分区锁时读盘（正在迁入本池的文件页先向 peer 取，
+            // peer 交出页面时要获取它自己的分区锁），同分区的其他访问不必等这次 I/O
+            // 调用方持有分区锁和已独占的帧，返回时仍持有锁；成功时页已 pin 住
+            bool LoadPage(Partition& part, std::unique_lock<std::mutex>& lock, frame_id_t fid,
+                          PageID page_id, AccessType access_type, ChecksumVerify verify);
+            bool MigrateFromPeers(PageID page_id, char* dest, bool* dirty);
+            // 作为迁出方：页在本池中时拷贝到 dest 并从本池移除，等待该页上在途的 I/O 和 pin 结束
+            bool HandOverPage(PageID page_id, char* dest, bool* dirty);
+            static const size_t FLUSH_BATCH_PAGES = 1024; //FlushAll 每批拷贝并写出的页数（4MB）
+            void BackgroundWriterLoop();
+            size_t BackgroundWriteRound(size_t budget); //返回本轮写出的页数
+            std::atomic<int> max_frames;
+            int capacity_frames_;
+            BufferPoolConfig config_;
+            std::unique_ptr<DiskManager> owned_disk_manager_;
+            DiskManager* disk_manager_;
+            std::unique_ptr<MemoryArena> page_arena_; //所有帧的页数据，第 i 帧占 [i * PAGE_SIZE, (i + 1) * PAGE_SIZE)
+            // 连续的帧数组，按帧号交错分给各分区（第 i 帧属于分区 i % 分区数），
+            // 使缩容时停用的帧正好是数组和页内存区的尾部
+            std::unique_ptr<Frame[]> frames_;
+            std::vector<std::unique_ptr<Partition>> partitions_;
+            // 本进程最近写出的页：按 PageID 哈希的直接映射表，冲突时覆盖，查不到时照常校验
+            static const size_t RECENT_WRITE_SLOTS = 4096;
+            std::unique_ptr<std::atomic<PageID>[]> recent_writes_;
+
+            std::thread bg_writer_;
+            std::atomic<bool> bg_writer_stop_{false};
+            std::mutex bg_writer_mutex_;
+            std::condition_variable bg_writer_cv_;
+            size_t bg_writer_next_partition_ = 0; //每轮从不同分区开始，保证预算公平
+
+            std::mutex flush_mutex_; //串行化 FlushAll：它持有本批帧的写标记时会等待别的写，两个 FlushAll 交叉等待会死锁
+
+            std::thread resize_thread_; //缩容的腾空线程，第一次 Resize 时启动
+            std::mutex resize_mutex_; //串行化 Resize，保护以下状态
+            std::condition_variable resize_cv_;
+            bool resize_stop_ = false;
+            uint64_t resize_generation_ = 0; //每次 Resize 加一，腾空线程据此判断一轮的结论是否过时
+            int registered_frames_ = 0; //注册给 I/O 引擎的帧数
+            std::atomic<bool> draining_{false};
+
+            std::shared_mutex migration_mutex_; //保护 peers_ 和 migrating_files_
+            std::vector<BufferPool*> peers_;
+            std::unordered_set<FileID> migrating_files_; //正在迁入本池的文件
+            std::atomic<int> num_migrating_files_{0}; //为 0 时未命中路径不必查集合
     };
 }
-#endif 
\ No newline at end of file
+#endif 
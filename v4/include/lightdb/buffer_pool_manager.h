@@ -0,0 +1,35 @@
+#ifndef LIGHTDB_BUFFER_POOL_MANAGER_H
+#define LIGHTDB_BUFFER_POOL_MANAGER_H
+#include "base.h"
+#include "lightdb/buffer_pool.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+namespace lightdb {
+    // 命名缓冲池：多个缓冲池共用一个 DiskManager，各自的容量和置换策略独立，
+    // 例如让热的 OLTP 索引独占一个池，批量扫描的大表无法挤占它的内存
+    // 表/索引通过 HeapFile::SetBufferPool、BTreeIndex::SetBufferPool（或 Catalog）在线改换所在的池，
+    // 已缓存的页不做整体搬迁，而是在新池未命中时逐页从旧池迁入
+    class BufferPoolManager {
+        public:
+            explicit BufferPoolManager(DiskManager* disk_manager);
+
+            // 创建名为 name 的缓冲池，重名时返回 nullptr；返回的指针在 BufferPoolManager 析构前有效
+            BufferPool* CreatePool(const std::string& name, int frames,
+                                   const BufferPoolConfig& config = BufferPoolConfig());
+            BufferPool* GetPool(const std::string& name) const; //不存在时返回 nullptr
+            std::string GetPoolName(const BufferPool* pool) const; //不是本管理器的池时返回空串
+            std::vector<std::pair<std::string, BufferPool*>> GetPools() const; //按名字排序
+            // 检查点：依次对每个池执行 BufferPool::FlushAll，返回是否全部写成功
+            bool FlushAll(bool sync_files = true);
+            DiskManager* GetDiskManager() const { return disk_manager_; }
+        private:
+            DiskManager* disk_manager_;
+            mutable std::mutex mutex_;
+            std::map<std::string, std::unique_ptr<BufferPool>> pools_;
+    };
+}
+#endif
@@ -0,0 +1,81 @@
+#ifndef LIGHTDB_BUFFER_POOL_STATS_H
+#define LIGHTDB_BUFFER_POOL_STATS_H
+#include "base.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+namespace lightdb {
+    // 延迟直方图：第 0 个桶为 [0, 1us)，第 i 个桶为 [2^(i-1), 2^i) us，最后一个桶收纳更长的延迟
+    // 只做一次无锁的 fetch_add，可在任意线程并发记录
+    class LatencyHistogram {
+        public:
+            static const int NUM_BUCKETS = 24; //最后一个桶下界约 4.2s
+
+            void Record(uint64_t nanos);
+            void Reset();
+            std::array<uint64_t, NUM_BUCKETS> Snapshot() const;
+            // 第 i 个桶的上界（微秒），最后一个桶返回 UINT64_MAX
+            static uint64_t BucketUpperMicros(int bucket);
+        private:
+            std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+    };
+
+    // 某一时刻的统计快照，可以是单个分区的，也可以是整个缓冲池的合计
+    struct BufferPoolStats {
+        uint64_t hits = 0; //页已在缓冲池中（含无锁命中）
+        uint64_t misses = 0; //需要分配帧并读盘
+        uint64_t evictions = 0; //置换器淘汰或策略环复用的帧
+        uint64_t evict_failures = 0; //所有帧都被 pin 住（或刷盘失败），无帧可淘汰
+        uint64_t frame_waits = 0; //取页时无帧可用而等待的次数
+        uint64_t frame_wait_timeouts = 0; //其中等到超时仍无帧、取页失败的次数
+        uint64_t frame_wait_nanos = 0; //等待可用帧的总时间
+        uint64_t dirty_flushes = 0; //前台淘汰/FlushPage 写回的脏页
+        uint64_t bg_writer_flushes = 0; //后台写线程写回的脏页
+        uint64_t prefetched_pages = 0; //预读提交的页
+        uint64_t checksum_failures = 0; //读盘后校验和不符的页
+        uint64_t checksum_skips = 0; //按 SKIP_SELF_WRITTEN 跳过校验的页
+        uint64_t migrated_pages = 0; //未命中时从其他缓冲池迁入（不经过磁盘）的页
+        uint64_t lock_acquisitions = 0; //分区锁获取次数
+        uint64_t lock_contended = 0; //其中需要等待的次数
+        uint64_t lock_wait_nanos = 0; //等待分区锁的总时间
+        uint64_t miss_nanos = 0; //未命中服务（分配帧 + 读盘）的总时间
+        std::array<uint64_t, LatencyHistogram::NUM_BUCKETS> miss_latency{}; //未命中服务时间的直方图
+
+        double HitRatio() const {
+            uint64_t total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+        }
+        // 由直方图估计的未命中服务时间分位数（微秒，取所在桶的上界），q 取 (0, 1]
+        uint64_t MissLatencyPercentileMicros(double q) const;
+        BufferPoolStats& operator+=(const BufferPoolStats& other);
+    };
+
+    // 每个分区一份的计数器，全部用 relaxed 原子操作累加，不参与任何同步
+    struct PartitionStats {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> evictions{0};
+        std::atomic<uint64_t> evict_failures{0};
+        std::atomic<uint64_t> frame_waits{0};
+        std::atomic<uint64_t> frame_wait_timeouts{0};
+        std::atomic<uint64_t> frame_wait_nanos{0};
+        std::atomic<uint64_t> dirty_flushes{0};
+        std::atomic<uint64_t> bg_writer_flushes{0};
+        std::atomic<uint64_t> prefetched_pages{0};
+        std::atomic<uint64_t> checksum_failures{0};
+        std::atomic<uint64_t> checksum_skips{0};
+        std::atomic<uint64_t> migrated_pages{0};
+        std::atomic<uint64_t> lock_acquisitions{0};
+        std::atomic<uint64_t> lock_contended{0};
+        std::atomic<uint64_t> lock_wait_nanos{0};
+        std::atomic<uint64_t> miss_nanos{0};
+        LatencyHistogram miss_latency;
+
+        static void Add(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+        BufferPoolStats Snapshot() const;
+        void Reset();
+    };
+}
+#endif
@@ -3,15 +3,21 @@
 
 #include "heap_file.h"
 #include "bplus_tree.h"
+#include "system_view.h"
+#include "buffer_pool_manager.h"
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace lightdb {
 
 struct TableInfo {
     std::string table_name;
     HeapFile* heap_file;
+    StorageMode storage_mode;
+    PageCompression compression;
+    std::string pool_name;  // 所在的命名缓冲池，未设置 BufferPoolManager 时为空
     // 实际项目中还应包含 Schema (列定义)
 };
 
@@ -20,19 +26,88 @@ struct IndexInfo {
     std::string table_name;
     std::string column_name;
     BTreeIndex* btree;
+    StorageMode storage_mode;
+    PageCompression compression;
+    std::string pool_name;
 };
 
 class Catalog {
 public:
     // 注册表
     void RegisterTable(const std::string& table_name, HeapFile* file) {
-        tables_[table_name] = {table_name, file};
+        tables_[table_name] = {table_name, file, file->GetStorageMode(), file->GetCompression(),
+                               PoolNameOf(file->GetBufferPool())};
     }
 
     // 注册索引
     void RegisterIndex(const std::string& table_name, const std::string& col_name, BTreeIndex* index) {
         std::string key = table_name + "." + col_name;
-        indexes_[key] = {"idx_" + key, table_name, col_name, index};
+        indexes_[key] = {"idx_" + key, table_name, col_name, index, index->GetStorageMode(), index->GetCompression(),
+                          PoolNameOf(index->GetBufferPool())};
+    }
+
+    // 打开表文件并注册，Catalog 持有打开的 HeapFile；按表选择经缓冲池读写或只读映射，以及磁盘上的页压缩
+    HeapFile* OpenTable(const std::string& table_name, const std::string& file_path, BufferPool* buffer_pool,
+                        StorageMode mode = StorageMode::BUFFER_POOL,
+                        PageCompression compression = PageCompression::NONE) {
+        owned_tables_.push_back(std::make_unique<HeapFile>(file_path, buffer_pool, mode, compression));
+        RegisterTable(table_name, owned_tables_.back().get());
+        return owned_tables_.back().get();
+    }
+
+    // 打开索引文件并注册，Catalog 持有打开的 BTreeIndex
+    BTreeIndex* OpenIndex(const std::string& table_name, const std::string& col_name, const std::string& file_path,
+                          BufferPool* buffer_pool, StorageMode mode = StorageMode::BUFFER_POOL,
+                          PageCompression compression = PageCompression::NONE) {
+        owned_indexes_.push_back(std::make_unique<BTreeIndex>(buffer_pool, file_path, 100, mode, compression));
+        RegisterIndex(table_name, col_name, owned_indexes_.back().get());
+        return owned_indexes_.back().get();
+    }
+
+    // 命名缓冲池：设置后可按池名把表/索引分配到某个池
+    void SetBufferPoolManager(BufferPoolManager* pool_manager) {
+        pool_manager_ = pool_manager;
+    }
+
+    // 把表改由名为 pool_name 的缓冲池服务，可在线调用：等待该表在途的操作结束后切换，
+    // 已缓存的页随后续访问逐步迁入新池
+    bool AssignTablePool(const std::string& table_name, const std::string& pool_name) {
+        TableInfo* info = GetTableInfo(table_name);
+        BufferPool* pool = pool_manager_ != nullptr ? pool_manager_->GetPool(pool_name) : nullptr;
+        if (info == nullptr || pool == nullptr) {
+            LOG_ERROR("AssignTablePool failed: unknown table " + table_name + " or buffer pool " + pool_name);
+            return false;
+        }
+        if (!info->heap_file->SetBufferPool(pool)) {
+            return false;
+        }
+        info->pool_name = pool_name;
+        return true;
+    }
+
+    bool AssignIndexPool(const std::string& table_name, const std::string& col_name, const std::string& pool_name) {
+        IndexInfo* info = GetIndex(table_name, col_name);
+        BufferPool* pool = pool_manager_ != nullptr ? pool_manager_->GetPool(pool_name) : nullptr;
+        if (info == nullptr || pool == nullptr) {
+            LOG_ERROR("AssignIndexPool failed: unknown index on " + table_name + "." + col_name + " or buffer pool " +
+                      pool_name);
+            return false;
+        }
+        if (!info->btree->SetBufferPool(pool)) {
+            return false;
+        }
+        info->pool_name = pool_name;
+        return true;
+    }
+
+    // 注册系统视图，与普通表共用名字空间，SELECT 时由 Planner 识别
+    void RegisterSystemView(const SystemView& view) {
+        system_views_[view.name] = view;
+    }
+
+    SystemView* GetSystemView(const std::string& view_name) {
+        auto it = system_views_.find(view_name);
+        return it != system_views_.end() ? &it->second : nullptr;
     }
 
     // 查找表
@@ -40,6 +115,11 @@ public:
         return tables_.find(table_name) != tables_.end();
     }
 
+    TableInfo* GetTableInfo(const std::string& table_name) {
+        auto it = tables_.find(table_name);
+        return it != tables_.end() ? &it->second : nullptr;
+    }
+
     // 查找索引 (用于优化器判断)
     IndexInfo* GetIndex(const std::string& table_name, const std::string& col_name) {
         std::string key = table_name + "." + col_name;
@@ -50,9 +130,17 @@ public:
     }
 
 private:
+    std::string PoolNameOf(const BufferPool* pool) const {
+        return pool_manager_ != nullptr ? pool_manager_->GetPoolName(pool) : "";
+    }
+
+    BufferPoolManager* pool_manager_ = nullptr;
     std::unordered_map<std::string, TableInfo> tables_;
     // Key: "table_name.column_name"
     std::unordered_map<std::string, IndexInfo> indexes_; 
+    std::unordered_map<std::string, SystemView> system_views_;
+    std::vector<std::unique_ptr<HeapFile>> owned_tables_;
+    std::vector<std::unique_ptr<BTreeIndex>> owned_indexes_;
 };
 
 } // namespace lightdb
@@ -0,0 +1,30 @@
+#ifndef LIGHTDB_CHECKSUM_H
+#define LIGHTDB_CHECKSUM_H
+#include "base.h"
+#include <cstddef>
+#include <cstdint>
+namespace lightdb {
+    // 每个磁盘页的最后 4 字节存放 CRC32C 校验和，页内数据只能使用前 PAGE_DATA_SIZE 字节
+    const int PAGE_CHECKSUM_SIZE = sizeof(uint32_t);
+    const int PAGE_DATA_SIZE = PAGE_SIZE - PAGE_CHECKSUM_SIZE;
+
+    // CRC32C (Castagnoli)；x86 上 CPU 支持 SSE4.2 时使用 crc32 指令，否则使用查表实现
+    // crc 为之前数据的校验和，可分段计算
+    uint32_t Crc32c(const char* data, size_t length, uint32_t crc = 0);
+    const char* Crc32cImplName(); //"sse4.2" 或 "table"
+    uint32_t Crc32cPortable(const char* data, size_t length, uint32_t crc = 0); //总是使用查表实现
+
+    // 页校验和覆盖页内数据和文件内页号，页被写到错误位置时也能发现
+    uint32_t ComputePageChecksum(const char* page, int32_t page_no);
+    void SetPageChecksum(char* page, int32_t page_no); //写盘前调用
+    // 读盘后调用；全零页（文件末尾之外或从未写过）视为有效
+    bool VerifyPageChecksum(const char* page, int32_t page_no);
+
+    // 读盘时的校验方式
+    enum class ChecksumVerify {
+        ALWAYS,
+        SKIP_SELF_WRITTEN, //跳过本进程最近写出的页：磁盘上的内容就是刚写下的，热路径上省掉一次计算
+        NEVER
+    };
+}
+#endif
@@ -0,0 +1,72 @@
+#ifndef LIGHTDB_COMPRESSED_FILE_H
+#define LIGHTDB_COMPRESSED_FILE_H
+#include "base.h"
+#include "lightdb/page_codec.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+namespace lightdb {
+    // 压缩存储的数据文件：逻辑页压缩后占用若干个连续扇区（变长槽），页号到物理位置的映射
+    // 保存在旁路的映射文件 <path>.pmap 中，重启后据此恢复
+    // 写页总是写到新分配的槽（写时复制），旧槽要等映射持久化后才能复用，
+    // 因此崩溃后映射文件指向的仍是完整的旧版本页
+    // 同一页的读与写由调用方（缓冲池的帧占有）保证不会并发
+    class CompressedPageFile {
+        public:
+            static const int SECTOR_SIZE = 512;
+            static const int MAX_SECTORS = PAGE_SIZE / SECTOR_SIZE; //压缩后放不下时原样存储
+
+            // data_fd 由调用方打开和关闭，须在本对象析构之后关闭
+            CompressedPageFile(int data_fd, const std::string& map_path, PageCompression compression);
+            ~CompressedPageFile(); //持久化映射并关闭映射文件
+            bool IsValid() const { return map_fd_ >= 0; }
+
+            bool ReadPage(int32_t page_no, char* page_data); //未写过的页按全零返回
+            bool WritePage(int32_t page_no, const char* page_data);
+            int32_t GetNumPages(); //已写过的最大页号 + 1
+            bool Sync(); //数据落盘后写入映射并落盘，之后旧槽才可复用
+
+            uint64_t GetLogicalBytes() const { return logical_bytes_.load(std::memory_order_relaxed); }
+            uint64_t GetPhysicalBytes() const { return physical_bytes_.load(std::memory_order_relaxed); }
+        private:
+            // 映射文件中的一项；length 为 0 表示该页未写过，等于 PAGE_SIZE 表示未压缩
+            struct Extent {
+                uint32_t sector;
+                uint16_t num_sectors;
+                uint16_t length;
+            };
+            static_assert(sizeof(Extent) == 8, "page map entries are persisted as raw bytes");
+            struct MapHeader {
+                uint32_t magic;
+                uint32_t version;
+                uint32_t num_pages;
+                uint32_t reserved;
+            };
+            static const uint32_t MAP_MAGIC = 0x4C504D50; //"LPMP"
+            static const uint32_t MAP_VERSION = 1;
+            static const size_t CHECKPOINT_PENDING = 256; //待释放的槽达到此数时自动持久化映射
+
+            bool LoadMap();
+            void RebuildFreeLists();
+            Extent Allocate(int num_sectors); //调用方持有 mutex_
+            void AddFree(uint32_t sector, int num_sectors);
+            bool CheckpointLocked();
+
+            int data_fd_;
+            int map_fd_;
+            std::string map_path_;
+            PageCompression compression_;
+            std::mutex mutex_;
+            std::vector<Extent> map_;
+            std::vector<std::vector<uint32_t>> free_; //按扇区数分组的空闲槽起始扇区
+            std::vector<Extent> pending_free_; //被新版本替换、等待映射持久化的旧槽
+            uint32_t end_sector_ = 0; //数据文件已使用部分的末尾
+            size_t dirty_begin_ = 0; //映射中未持久化的页号范围 [dirty_begin_, dirty_end_)
+            size_t dirty_end_ = 0;
+            std::atomic<uint64_t> logical_bytes_{0}; //当前各页未压缩的总字节数
+            std::atomic<uint64_t> physical_bytes_{0}; //当前各页占用的槽总字节数
+    };
+}
+#endif
@@ -0,0 +1,78 @@
+#ifndef LIGHTDB_DISK_MANAGER_H
+#define LIGHTDB_DISK_MANAGER_H
+#include "base.h"
+#include "lightdb/logger.h"
+#include "lightdb/io_engine.h"
+#include "lightdb/compressed_file.h"
+#include <functional>
+#include <memory>
+#include <condition_variable>
+#include <string>
+#include <vector>
+#include <mutex>
+namespace lightdb {
+    // 批量页 I/O 中的一页
+    struct PageIO {
+        PageID page_id;
+        char* data;
+        bool ok = false; //同步批量接口返回时填入该页是否成功
+    };
+    using PageIOCallback = std::function<void(PageID page_id, bool ok)>;
+
+    // 磁盘管理器：负责表文件/索引文件的打开与按页读写
+    // 每个文件对应一个 FileID，页在文件中的偏移为 page_no * PAGE_SIZE
+    // 单页读写直接使用 pread/pwrite；批量读写交给 I/O 引擎，io_uring 下整批只需一次系统调用
+    // 以压缩方式打开的文件由 CompressedPageFile 负责页的压缩与定位，缓冲池中的帧始终是未压缩的页
+    class DiskManager {
+        public:
+            explicit DiskManager(bool use_direct_io = false, IOEngineType io_engine = IOEngineType::SYNC);
+            ~DiskManager();
+
+            // 同一路径重复打开返回相同 FileID（沿用第一次打开时的压缩方式）
+            // 压缩文件不使用 O_DIRECT，页映射保存在 file_path + ".pmap"
+            FileID OpenFile(const std::string& file_path, PageCompression compression = PageCompression::NONE);
+            bool ReadPage(PageID page_id, char* page_data); //超出文件末尾的页按全零返回
+            bool WritePage(PageID page_id, const char* page_data);
+            int32_t GetNumPages(FileID file_id); //文件当前已落盘的页数
+            void SyncFile(FileID file_id); //不持有 mutex_ 时同步，不阻塞其他文件的读写
+            bool IsDirectIO() const { return use_direct_io_; }
+            bool IsDirectIO(FileID file_id); //文件实际是否以 O_DIRECT 打开（不支持时会退回缓冲 I/O）
+            bool IsCompressed(FileID file_id);
+            // 压缩文件中各页未压缩/实际占用的总字节数，非压缩文件两者都是页数 * PAGE_SIZE
+            bool GetCompressionStats(FileID file_id, uint64_t* logical_bytes, uint64_t* physical_bytes);
+
+            // 异步提交一批页读/写，每页完成时回调（io_uring 下在完成线程中执行，回调内不能等待 I/O）
+            // 返回时请求不一定已完成，完成前 data 必须保持有效
+            void ReadPagesAsync(const std::vector<PageIO>& pages, const PageIOCallback& callback);
+            void WritePagesAsync(const std::vector<PageIO>& pages, const PageIOCallback& callback);
+            // 压缩文件的页在提交线程中同步压缩/解压并读写，回调随即执行
+            // 提交一批页读/写并等待全部完成，全部成功时返回 true
+            bool ReadPages(std::vector<PageIO>& pages);
+            bool WritePages(std::vector<PageIO>& pages);
+            // 常驻的页缓冲区（如缓冲池帧数组）注册给 I/O 引擎，落在其中的批量 I/O 使用固定缓冲区
+            void RegisterBufferRegion(void* base, size_t length) { io_engine_->RegisterBufferRegion(base, length); }
+            void UnregisterBufferRegion(void* base, size_t length) { io_engine_->UnregisterBufferRegion(base, length); }
+            const char* GetIOEngineName() const { return io_engine_->Name(); }
+            bool IsAsyncIO() const { return io_engine_->IsAsync(); }
+        private:
+            struct FileHandle {
+                std::string path;
+                int fd;
+                bool direct_io;
+                std::unique_ptr<CompressedPageFile> compressed; //仅压缩文件
+            };
+            // 返回页所在文件的 fd；压缩文件另外通过 compressed 返回（对象地址在 DiskManager 析构前不变）
+            int GetFd(PageID page_id, bool* direct_io, CompressedPageFile** compressed = nullptr);
+            void SubmitPages(const std::vector<PageIO>& pages, bool is_write,
+                             const std::function<void(size_t index, bool ok)>& callback);
+            bool SubmitPagesAndWait(std::vector<PageIO>& pages, bool is_write);
+
+            bool use_direct_io_;
+            std::vector<FileHandle> files_;
+            std::mutex mutex_;
+            int syncs_in_flight_ = 0; //正在进行的 SyncFile，析构时等它们结束后才关闭文件（受 mutex_ 保护）
+            std::condition_variable syncs_done_;
+            std::unique_ptr<IOEngine> io_engine_;
+    };
+}
+#endif
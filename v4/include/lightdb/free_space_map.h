@@ -0,0 +1,49 @@
+#ifndef LIGHTDB_FREE_SPACE_MAP_H
+#define LIGHTDB_FREE_SPACE_MAP_H
+#include "base.h"
+#include "lightdb/buffer_pool.h"
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+namespace lightdb {
+    // 空闲空间映射（FSM）：每个堆页用 1 字节记录空闲空间的档位（以 FSM_CATEGORY_BYTES 为单位向下取整），
+    // 持久化在表文件旁的 <path>.fsm 中，每个 FSM 页记录 PAGE_DATA_SIZE 个堆页，经缓冲池读写；
+    // 内存中另建一棵最大值线段树，查找"空闲空间至少 N 字节的页"只需 O(log n)
+    // FSM 只是提示：记录的值可能过时，调用方在页上加写闩后须以实际空闲空间为准，不一致时用 Update 纠正
+    class FreeSpaceMap {
+        public:
+            static const int FSM_CATEGORY_BYTES = 16;
+
+            // 打开(或创建) FSM 文件；num_heap_pages 为堆文件当前的页数
+            // 尚未记录过的堆页（如 FSM 文件缺失或未刷盘）由 read_free_space 读取堆页得出，并写回 FSM
+            FreeSpaceMap(const std::string& path, BufferPool* buffer_pool, int32_t num_heap_pages,
+                         const std::function<int(int32_t page_no)>& read_free_space);
+
+            // 返回空闲空间至少 required 字节的页号（页号最小者优先），没有时返回 -1
+            int32_t FindPage(int required);
+            // 记录 page_no 当前的空闲空间；page_no 超出已知范围时扩展，档位变化时写回 FSM 页
+            // 写回要经缓冲池取 FSM 页，调用方不应持有堆页的闩
+            void Update(int32_t page_no, int free_space);
+            FileID GetFileID() const { return file_id_; }
+            // 调用方须保证切换期间没有并发的 FindPage/Update（HeapFile 在排他的 pool_latch_ 下调用）
+            void SetBufferPool(BufferPool* buffer_pool) { buffer_pool_ = buffer_pool; }
+        private:
+            // FSM 页中的取值：0 表示未记录，否则为档位 + 1
+            static uint8_t Encode(int free_space);
+            void Grow(int32_t num_pages); //调用方需持有 mutex_
+            void SetLeaf(int32_t page_no, uint8_t value); //更新线段树，调用方需持有 mutex_
+            // 把线段树中 page_no 的当前值写回 FSM 页，调用方不能持有 mutex_（先加 FSM 页的写闩再取 mutex_）
+            bool Persist(int32_t page_no);
+
+            std::string path_;
+            BufferPool* buffer_pool_;
+            FileID file_id_;
+            std::mutex mutex_; //保护线段树；写回 FSM 页时不持有
+            int32_t num_pages_ = 0; //已知的堆页数
+            size_t leaves_ = 1; //线段树叶子数，2 的幂
+            std::vector<uint8_t> tree_; //tree_[1] 为根，第 i 个堆页对应 tree_[leaves_ + i]，内部节点取子节点的最大值
+    };
+}
+#endif
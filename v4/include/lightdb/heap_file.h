@@ -3,28 +3,123 @@
 
 #include "lightdb/page.h"
 #include "lightdb/buffer_pool.h"
+#include "lightdb/free_space_map.h"
+#include "lightdb/mmap_file.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 namespace lightdb {
     struct Record {
         std::string data;
         RID rid;
     };
+    class HeapFile;
+    class TableIterator;
+    // 记录的只读引用：GetData 直接指向缓冲池帧（或映射的文件）中的记录，不分配内存也不拷贝，
+    // 过滤、投影可以原地检查字节，只拷贝留下来的行
+    // HeapFile::ReadRecordRef 返回的引用自己持有页的 pin 和读闩，析构时释放，持有期间该页不能被修改；
+    // TableIterator::NextRef 返回的引用借用游标当前页的读闩，只在游标下一次 Next/NextRef 之前有效
+    class RecordRef {
+        public:
+            RecordRef() = default;
+            explicit operator bool() const { return rid_.page_id != INVALID_PAGE_ID; } //记录不存在或已删除时为 false
+            std::string_view GetData() const { return data_; }
+            const RID& GetRID() const { return rid_; }
+            Record ToRecord() const { return Record{std::string(data_), rid_}; } //拷贝出记录
+        private:
+            friend class HeapFile;
+            friend class TableIterator;
+            ReadPageGuard guard_; //借用游标的页或映射模式下为无效守卫
+            std::string_view data_;
+            RID rid_;
+    };
+    // 表的顺序扫描游标（由 HeapFile::Scan 创建）：逐条返回未删除的记录，内存占用与表的大小无关
+    // 只 pin 住当前一小批页（缓冲池模式下按批取页并预读），每次 Next 在当前页上短暂加读闩取出一条记录，
+    // 离开一页即 unpin；提前结束扫描只需销毁游标。扫描期间并发插入、删除的记录可能返回也可能不返回
+    // NextRef 不拷贝记录，游标对当前页持续持有读闩直到离开该页或改用 Next，期间不要修改本表
+    // 游标存活期间持有表的共享锁，表不能切换缓冲池，游标应随用随弃
+    class TableIterator {
+        public:
+            TableIterator(TableIterator&& other) = default;
+            TableIterator& operator=(TableIterator&&) = delete;
+            ~TableIterator();
+            // 取下一条记录，扫描结束时返回 false
+            bool Next(Record* record);
+            // 取下一条记录的引用，扫描结束时返回 false 并置 ref 为空引用
+            bool NextRef(RecordRef* ref);
+        private:
+            friend class HeapFile;
+            TableIterator(HeapFile* table, int32_t begin_page_no, int32_t end_page_no);
+            // 定位下一条记录，返回时（缓冲池模式下）持有所在页的读闩
+            bool Advance(std::string_view* record_data, RID* rid);
+            bool FetchBatch(); //unpin 上一批剩余的页并取下一批，没有更多的页时返回 false
+            void ReleaseBatch();
+
+            HeapFile* table_;
+            std::shared_lock<std::shared_mutex> pool_lock_;
+            std::unique_ptr<BufferAccessStrategy> strategy_; //仅 BUFFER_POOL 模式
+            int32_t next_page_no_; //下一个待取的页号
+            int32_t end_page_no_;
+            std::vector<Page*> batch_; //当前一批已 pin 住的页，已经扫描完的页置为 nullptr
+            size_t batch_pos_ = 0;
+            std::shared_lock<std::shared_mutex> page_latch_; //当前页的读闩
+            const char* mapped_page_ = nullptr; //MMAP_READ_ONLY 模式下当前的页
+            PageID page_id_ = INVALID_PAGE_ID;
+            int slot_id_ = 0; //当前页中下一个要检查的槽
+    };
     class HeapFile {
         public:
-            explicit HeapFile(const std::string& file_path, BufferPool* buffer_pool)
-                : file_path_(file_path), buffer_pool_(buffer_pool), next_page_id_(0){}
+            static const int32_t DEFAULT_MORSEL_PAGES = 64; //ParallelScan 每个工作单元的页数
+            // 打开(或创建)表文件，页数由文件大小决定
+            // 可写的表在 <file_path>.fsm 中维护空闲空间映射，插入由它找到空间足够的页
+            // MMAP_READ_ONLY 模式下整个文件只读映射，读取不经过缓冲池，插入和删除会失败
+            // compression 为页在磁盘上的压缩方式，压缩文件无法映射，此时退回 BUFFER_POOL 模式
+            HeapFile(const std::string& file_path, BufferPool* buffer_pool,
+                     StorageMode mode = StorageMode::BUFFER_POOL,
+                     PageCompression compression = PageCompression::NONE);
             RID InsertRecord(const Record& record);
             Record ReadRecord(const RID& rid);
-            bool DeleteRecord(const RID& rid);
-            std::vector<Record> SeqScan(); //扫描所有未删除记录
+            RecordRef ReadRecordRef(const RID& rid); //不拷贝记录，引用持有页的 pin 和读闩，应随用随弃
+            bool DeleteRecord(const RID& rid); //删除后整理页内空间，其他记录的 RID 不变
+            std::vector<Record> SeqScan(); //扫描所有未删除记录，一次返回整张表
+            // 按页号扫描 [begin_page_no, end_page_no) 中的记录，end_page_no 为负时扫到创建游标时的最后一页
+            TableIterator Scan(int32_t begin_page_no = 0, int32_t end_page_no = -1);
+            // 并行全表扫描：页范围切成每块 morsel_pages 页的工作单元，num_threads 个线程（含调用线程）动态领取，
+            // 各自在本线程内对记录原地求值 predicate，只拷贝满足条件的行；结果按 RID 顺序合并返回
+            // predicate 为空时返回所有记录，它会被多个线程同时调用；num_threads <= 0 时取硬件线程数
+            // 缓冲池模式下线程数不超过帧数 / (2 * SCAN_BATCH_PAGES)，避免各线程 pin 住的页占满缓冲池
+            std::vector<Record> ParallelScan(const std::function<bool(const RecordRef&)>& predicate = nullptr,
+                                             int num_threads = 0, int32_t morsel_pages = DEFAULT_MORSEL_PAGES);
+            StorageMode GetStorageMode() const { return mode_; }
+            PageCompression GetCompression() const { return compression_; }
+            // 在线改由另一个缓冲池（须共用同一 DiskManager，如 BufferPoolManager 中的池）服务本表：
+            // 等待在途的操作结束后切换，已缓存的页在新池访问到时才从旧池迁入
+            bool SetBufferPool(BufferPool* buffer_pool);
+            BufferPool* GetBufferPool();
         private:
-            Page* GetFreePage(const Record& record);
-            int SerializeRecord(const Record& record, char* dest);
+            friend class TableIterator;
+            static const int32_t SCAN_BATCH_PAGES = 16; //扫描每次批量取的页数
+            WritePageGuard GetFreePage(const Record& record); //返回已加写闩、空间足够的页，FSM 中没有时新建一页
+            // 解析页内数据（格式见 HeapPageHeader），两种存储模式共用
+            static int GetFreeSpace(const char* data); //还能容纳的记录数据与槽的字节数（不计可复用的已删除槽，最多少算一个槽）
+            static void CompactPage(char* data); //把未删除的记录紧凑地移到数据区末尾，已删除的槽长度置零，末尾的已删除槽去掉
+            static bool ReadSlot(const char* data, int slot_id, std::string_view* record_data);
+            // 返回槽号不小于 slot_id 的第一条未删除记录的槽号，页内没有更多记录时返回 -1
+            static int NextSlot(const char* data, int slot_id, std::string_view* record_data);
 
             std::string file_path_;
             BufferPool* buffer_pool_;
-            PageID next_page_id_;
+            std::shared_mutex pool_latch_; //每个操作持共享锁，切换缓冲池时持排他锁
+            FileID file_id_;
+            std::atomic<int32_t> next_page_id_; //文件内下一个待分配的页号
+            StorageMode mode_;
+            PageCompression compression_;
+            std::unique_ptr<MmapFile> mmap_file_; //仅 MMAP_READ_ONLY 模式
+            std::unique_ptr<FreeSpaceMap> fsm_; //仅 BUFFER_POOL 模式
     };
 }
 #endif 
\ No newline at end of file
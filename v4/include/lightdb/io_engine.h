@@ -0,0 +1,110 @@
+#ifndef LIGHTDB_IO_ENGINE_H
+#define LIGHTDB_IO_ENGINE_H
+#include "base.h"
+#include <sys/types.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace lightdb {
+    enum class IOEngineType {
+        SYNC,     //pread/pwrite，在提交线程中同步完成
+        IO_URING  //io_uring 异步提交，由完成线程回调
+    };
+
+    using IOCallback = std::function<void(bool ok)>;
+
+    // 一次页级 I/O 请求，由 DiskManager 把 PageID 解析为 fd 与偏移
+    struct IORequest {
+        bool is_write;
+        int fd;
+        off_t offset;
+        char* buffer;
+        size_t length;
+        IOCallback callback; //完成时调用；io_uring 下可能在完成线程或其他提交线程中执行，必须简短且不能再提交或等待 I/O
+    };
+
+    // I/O 引擎：一次提交一批请求，每个请求完成时回调
+    class IOEngine {
+        public:
+            virtual ~IOEngine() = default;
+            virtual void Submit(std::vector<IORequest>& requests) = 0;
+            // 把一段常驻内存（如缓冲池帧数组）注册给内核，落在其中的缓冲区可免去每次 I/O 的页表映射
+            virtual void RegisterBufferRegion(void* /*base*/, size_t /*length*/) {}
+            virtual void UnregisterBufferRegion(void* /*base*/, size_t /*length*/) {} //内存释放前调用
+            virtual bool IsAsync() const = 0; //Submit 是否不等 I/O 完成就返回
+            virtual const char* Name() const = 0;
+    };
+
+    // 创建指定类型的引擎；io_uring 不可用时退回同步引擎
+    std::unique_ptr<IOEngine> MakeIOEngine(IOEngineType type);
+
+    // 完整读写一段数据，读到文件末尾时剩余部分填零
+    bool PreadFull(int fd, char* buffer, size_t length, off_t offset);
+    bool PwriteFull(int fd, const char* buffer, size_t length, off_t offset);
+
+    // 逐个同步执行；同一文件上偏移连续的读（写）请求合成一次 preadv（pwritev）
+    class SyncIOEngine : public IOEngine {
+        public:
+            void Submit(std::vector<IORequest>& requests) override;
+            bool IsAsync() const override { return false; }
+            const char* Name() const override { return "sync"; }
+        private:
+            void SubmitOne(IORequest& req);
+    };
+
+    // 直接基于 io_uring 系统调用实现（不依赖 liburing）
+    // 提交方把一批 SQE 填入提交队列后只调用一次 io_uring_enter；后台完成线程收割 CQE 并执行回调，
+    // 提交方在提交后也会顺手收割已经完成的请求
+    class IoUringEngine : public IOEngine {
+        public:
+            static const unsigned DEFAULT_QUEUE_DEPTH = 256;
+            explicit IoUringEngine(unsigned queue_depth = DEFAULT_QUEUE_DEPTH);
+            ~IoUringEngine();
+
+            bool IsValid() const { return ring_fd_ >= 0; }
+            void Submit(std::vector<IORequest>& requests) override;
+            void RegisterBufferRegion(void* base, size_t length) override;
+            void UnregisterBufferRegion(void* base, size_t length) override;
+            bool IsAsync() const override { return true; }
+            const char* Name() const override { return "io_uring"; }
+        private:
+            struct Region {
+                char* base;
+                size_t length;
+            };
+            int FindRegion(const char* buffer, size_t length) const;
+            void UpdateRegions(std::vector<Region> regions); //替换整张缓冲区表，调用方需持有 submit_mutex_ 且无在途请求
+            unsigned ReapCompletions(); //调用方需持有 reap_mutex_，返回收割的 CQE 数
+            void CompletionLoop();
+            void SubmitNop(); //唤醒完成线程以便退出
+
+            int ring_fd_ = -1;
+            unsigned sq_entries_ = 0;
+            void* sq_ring_ = nullptr;
+            void* cq_ring_ = nullptr;
+            size_t sq_ring_size_ = 0;
+            size_t cq_ring_size_ = 0;
+            void* sqes_ = nullptr;
+            size_t sqes_size_ = 0;
+            unsigned* sq_tail_ = nullptr;
+            unsigned* sq_mask_ = nullptr;
+            unsigned* sq_array_ = nullptr;
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            unsigned* cq_mask_ = nullptr;
+            void* cqes_ = nullptr;
+
+            std::mutex submit_mutex_;
+            std::condition_variable slots_available_;
+            unsigned in_flight_ = 0; //已提交未完成的请求数，不超过 sq_entries_，避免完成队列溢出
+            std::mutex reap_mutex_; //完成队列同一时间只由一个线程收割
+            std::vector<Region> regions_; //已注册的固定缓冲区
+            std::atomic<bool> stopping_{false};
+            std::thread completion_thread_;
+    };
+}
+#endif
@@ -5,6 +5,7 @@
 #include <string>
 #include <iostream>
 #include <ctime>
+#include <atomic>
 
 namespace lightdb {
     enum class LogLevel {
@@ -18,6 +19,7 @@ namespace lightdb {
             static Logger& GetInstance();
 
             void SetLogLevel(LogLevel level);
+            bool IsEnabled(LogLevel level) const { return current_level_ <= level; }
 
             void Debug(const std::string& msg);
             void Info(const std::string& msg);
@@ -30,11 +32,12 @@ namespace lightdb {
 
             std::string GetLogPrefix(LogLevel level);
 
-            LogLevel current_level_ = LogLevel::INFO;
+            std::atomic<LogLevel> current_level_{LogLevel::INFO}; //多线程下读取日志级别
     };
-    #define LOG_DEBUG(msg) lightdb::Logger::GetInstance().Debug(msg);
-    #define LOG_INFO(msg) lightdb::Logger::GetInstance().Info(msg);
-    #define LOG_WARN(msg) lightdb::Logger::GetInstance().Warn(msg);
-    #define LOG_ERROR(msg) lightdb::Logger::GetInstance().Error(msg);
+    // 先判断日志级别再拼接消息，热路径上被过滤的日志不产生字符串构造开销
+    #define LOG_DEBUG(msg) do { if (lightdb::Logger::GetInstance().IsEnabled(lightdb::LogLevel::DEBUG)) lightdb::Logger::GetInstance().Debug(msg); } while (0);
+    #define LOG_INFO(msg) do { if (lightdb::Logger::GetInstance().IsEnabled(lightdb::LogLevel::INFO)) lightdb::Logger::GetInstance().Info(msg); } while (0);
+    #define LOG_WARN(msg) do { if (lightdb::Logger::GetInstance().IsEnabled(lightdb::LogLevel::WARN)) lightdb::Logger::GetInstance().Warn(msg); } while (0);
+    #define LOG_ERROR(msg) do { if (lightdb::Logger::GetInstance().IsEnabled(lightdb::LogLevel::ERROR)) lightdb::Logger::GetInstance().Error(msg); } while (0);
 }
 #endif 
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef LIGHTDB_MEMORY_ARENA_H
+#define LIGHTDB_MEMORY_ARENA_H
+#include "base.h"
+#include <cstddef>
+namespace lightdb {
+    const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    enum class HugePageMode {
+        NONE, //普通 4KB 页
+        TRANSPARENT, //madvise(MADV_HUGEPAGE)，由内核透明大页机制按需合并
+        EXPLICIT //MAP_HUGETLB 从预留的大页池分配，失败时退回透明大页
+    };
+
+    // 一整块匿名映射的内存区域，起始地址按 2MB 对齐，内容初始为零
+    // 大页不可用时自动退回普通页，不影响正确性
+    class MemoryArena {
+        public:
+            // prefault 为 true 时在构造时触碰所有页，避免首次访问承担缺页开销
+            MemoryArena(size_t length, HugePageMode mode, bool prefault);
+            ~MemoryArena();
+            MemoryArena(const MemoryArena&) = delete;
+            MemoryArena& operator=(const MemoryArena&) = delete;
+
+            char* Data() const { return base_; }
+            size_t Size() const { return length_; }
+            const char* BackingName() const; //实际使用的页类型
+            // 预先分配并映射 [offset, offset + length) 的物理内存
+            void Populate(size_t offset, size_t length);
+            // 归还 [offset, offset + length) 的物理内存，虚拟地址保留，再次访问时得到清零的页
+            void Discard(size_t offset, size_t length);
+        private:
+
+            char* base_ = nullptr;
+            size_t length_ = 0; //请求的长度
+            size_t mapped_length_ = 0; //实际映射的长度（按页大小向上取整）
+            HugePageMode backing_ = HugePageMode::NONE;
+    };
+}
+#endif
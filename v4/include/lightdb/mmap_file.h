@@ -0,0 +1,43 @@
+#ifndef LIGHTDB_MMAP_FILE_H
+#define LIGHTDB_MMAP_FILE_H
+#include "base.h"
+#include <string>
+namespace lightdb {
+    // 表/索引文件的访问方式，可按表在 Catalog 中选择
+    enum class StorageMode {
+        BUFFER_POOL, //经缓冲池读写
+        MMAP_READ_ONLY //整个文件只读映射，页访问只是指针运算；用于读多写少的分析表
+    };
+
+    enum class MmapAdvice {
+        NORMAL,
+        SEQUENTIAL, //顺序扫描：内核加大预读，读过的页尽快回收
+        RANDOM //索引点查：关闭内核预读
+    };
+
+    // 只读映射一个数据文件；映射在打开时按当时的文件大小建立，之后的追加写不可见
+    // 经缓冲池写入的数据需先刷盘（缓冲池析构或 FlushPage）才能通过映射读到
+    class MmapFile {
+        public:
+            explicit MmapFile(const std::string& file_path);
+            ~MmapFile();
+            MmapFile(const MmapFile&) = delete;
+            MmapFile& operator=(const MmapFile&) = delete;
+
+            bool IsValid() const { return num_pages_ >= 0; } //文件打开或映射失败时为 false
+            int32_t GetNumPages() const { return num_pages_; }
+            // 文件内第 page_no 页的起始地址，越界时返回 nullptr
+            const char* GetPage(int32_t page_no) const {
+                if (page_no < 0 || page_no >= num_pages_) {
+                    return nullptr;
+                }
+                return base_ + static_cast<size_t>(page_no) * PAGE_SIZE;
+            }
+            void Advise(MmapAdvice advice) const;
+        private:
+            const char* base_ = nullptr;
+            size_t length_ = 0;
+            int32_t num_pages_ = 0;
+    };
+}
+#endif
@@ -2,25 +2,34 @@
 #define LIGHTDB_PAGE_H
 #include "base.h"
 #include "lightdb/base.h"
+#include <atomic>
 #include <cstring>
+#include <shared_mutex>
 namespace lightdb {
-    struct RecordHeader {
-        bool is_deleted;
-        int32_t record_size;
+    // 堆页（slotted page）：页头持久化在页首，其后是向后增长的槽数组，记录数据从页内数据区末尾
+    // （PAGE_DATA_SIZE）向前增长，二者之间为空闲空间。按 RID 读取记录只需按 slot_id 取一个槽，
+    // 文件重新打开或被映射读取时据此恢复页内记录；全零的页即为空页
+    struct HeapPageHeader {
+        int32_t slot_count;
+        int32_t data_begin; //记录数据区的起始偏移，0 表示尚未写入记录（等同于 PAGE_DATA_SIZE）
     };
+    // 槽：记录在页内的偏移和长度；删除只置标记，槽号（即 RID 的 slot_id）不变，已删除的槽可被之后的插入复用
+    struct HeapSlot {
+        uint16_t offset;
+        uint16_t length;
+        uint16_t flags;
+    };
+    const uint16_t HEAP_SLOT_DELETED = 1;
     struct Page {
         public:
-            PageID page_id;
+            std::atomic<PageID> page_id; //缓冲池无锁命中路径会并发读取
             int pin_count; 
             bool is_dirty;
-            char data[PAGE_SIZE];
-            int record_count = 0;
-            int used_data_size = 0;
+            char* data; //指向缓冲池页内存区中按页对齐的一块，由缓冲池在构造时设置
+            std::shared_mutex latch; //页内容的读写闩，由 ReadPageGuard/WritePageGuard 持有
 
             Page(PageID pid = INVALID_PAGE_ID)
-                : page_id(pid), pin_count(0), is_dirty(false) {
-                memset(data, 0, PAGE_SIZE);
-            }
+                : page_id(pid), pin_count(0), is_dirty(false), data(nullptr) {}
             char* GetData() {
                 return data;
             }
@@ -30,7 +39,6 @@ namespace lightdb {
                 is_dirty = false;
                 memset(data, 0, PAGE_SIZE);
             }
-            int GetFreeSpace();
     };
 }
 #endif 
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef LIGHTDB_PAGE_CODEC_H
+#define LIGHTDB_PAGE_CODEC_H
+#include "base.h"
+namespace lightdb {
+    // 数据文件的页压缩方式，按表/索引选择
+    enum class PageCompression {
+        NONE,
+        LZ //树内的 LZ77 编码，格式与 LZ4 块格式类似
+    };
+
+    // 压缩 src 的 src_len 字节到 dst，返回压缩后的长度；结果放不进 dst_capacity 时返回 0
+    // src_len 不超过 64KB（匹配偏移为 16 位）
+    int LzCompress(const char* src, int src_len, char* dst, int dst_capacity);
+    // 解压，返回解压后的长度；输入损坏或输出超出 dst_capacity 时返回 -1，不会越界读写
+    int LzDecompress(const char* src, int src_len, char* dst, int dst_capacity);
+}
+#endif
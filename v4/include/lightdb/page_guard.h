@@ -0,0 +1,56 @@
+#ifndef LIGHTDB_PAGE_GUARD_H
+#define LIGHTDB_PAGE_GUARD_H
+#include "base.h"
+#include "lightdb/page.h"
+namespace lightdb {
+    class BufferPool;
+
+    // 页守卫：持有页面的 pin 与读写闩，析构时自动解闩并 unpin
+    // 只能移动不能拷贝；移走或 Drop() 之后守卫失效
+    class ReadPageGuard {
+        public:
+            ReadPageGuard() = default;
+            ReadPageGuard(BufferPool* buffer_pool, Page* page); //page 须已被 pin 且持有读闩
+            ReadPageGuard(const ReadPageGuard&) = delete;
+            ReadPageGuard& operator=(const ReadPageGuard&) = delete;
+            ReadPageGuard(ReadPageGuard&& other) noexcept;
+            ReadPageGuard& operator=(ReadPageGuard&& other) noexcept;
+            ~ReadPageGuard() { Drop(); }
+
+            void Drop(); //提前释放读闩与 pin
+            bool IsValid() const { return page_ != nullptr; }
+            explicit operator bool() const { return IsValid(); }
+            PageID GetPageID() const { return page_->page_id; }
+            const Page* GetPage() const { return page_; }
+            const char* GetData() const { return page_->data; }
+        private:
+            BufferPool* buffer_pool_ = nullptr;
+            Page* page_ = nullptr;
+    };
+
+    // 写守卫持有排他闩；通过 GetPageMut()/GetDataMut() 取得可写指针时页面被标记为脏页
+    class WritePageGuard {
+        public:
+            WritePageGuard() = default;
+            WritePageGuard(BufferPool* buffer_pool, Page* page); //page 须已被 pin 且持有写闩
+            WritePageGuard(const WritePageGuard&) = delete;
+            WritePageGuard& operator=(const WritePageGuard&) = delete;
+            WritePageGuard(WritePageGuard&& other) noexcept;
+            WritePageGuard& operator=(WritePageGuard&& other) noexcept;
+            ~WritePageGuard() { Drop(); }
+
+            void Drop(); //提前释放写闩与 pin
+            bool IsValid() const { return page_ != nullptr; }
+            explicit operator bool() const { return IsValid(); }
+            PageID GetPageID() const { return page_->page_id; }
+            const Page* GetPage() const { return page_; }
+            const char* GetData() const { return page_->data; }
+            Page* GetPageMut() { is_dirty_ = true; return page_; }
+            char* GetDataMut() { is_dirty_ = true; return page_->data; }
+        private:
+            BufferPool* buffer_pool_ = nullptr;
+            Page* page_ = nullptr;
+            bool is_dirty_ = false;
+    };
+}
+#endif
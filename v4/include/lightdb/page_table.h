@@ -0,0 +1,40 @@
+#ifndef LIGHTDB_PAGE_TABLE_H
+#define LIGHTDB_PAGE_TABLE_H
+#include "base.h"
+#include <atomic>
+#include <memory>
+namespace lightdb {
+    using frame_id_t = int32_t;
+    const frame_id_t INVALID_FRAME_ID = -1;
+
+    // 缓冲池页表：PageID -> 帧下标
+    // 线性探测的开放寻址哈希表，容量在构造时固定，插入/删除不做任何内存分配
+    // 并发约定：Insert/Erase 由调用方互斥（分区锁），Find 可与它们并发且不加锁。
+    // 每个槽位是一个 64 位原子量，Find 读到的 (PageID, 帧) 总是某一时刻真实存在过的映射；
+    // 删除时的后移可能让并发的 Find 短暂地找不到仍然存在的页，调用方需在加锁后再查一次
+    class PageTable {
+        public:
+            explicit PageTable(size_t max_entries);
+
+            // 空槽与 INVALID_PAGE_ID 的编码相同，三个操作对 INVALID_PAGE_ID 都直接返回 false
+            bool Find(PageID page_id, frame_id_t* frame_id) const; //无锁
+            bool Insert(PageID page_id, frame_id_t frame_id); //已存在或表满时返回 false
+            bool Erase(PageID page_id);
+            size_t Size() const { return size_; }
+        private:
+            // 高 32 位为 PageID，低 32 位为帧下标
+            static uint64_t Pack(PageID page_id, frame_id_t frame_id) {
+                return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+            }
+            static PageID SlotPage(uint64_t slot) { return static_cast<PageID>(slot >> 32); }
+            static frame_id_t SlotFrame(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFFu); }
+            size_t Hash(PageID page_id) const;
+
+            std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+            size_t capacity_;
+            size_t mask_;
+            int hash_shift_;
+            size_t size_;
+    };
+}
+#endif
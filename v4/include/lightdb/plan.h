@@ -12,6 +12,7 @@ namespace lightdb {
 enum class PlanType {
     SEQ_SCAN,
     INDEX_SCAN,
+    SYSTEM_VIEW_SCAN,
     INSERT,
     DELETE,
     UPDATE,
@@ -51,6 +52,17 @@ struct IndexScanPlan : Plan {
     }
 };
 
+// 2.1 系统视图扫描计划：行由 Catalog 中注册的 SystemView 现场生成
+struct SystemViewScanPlan : Plan {
+    std::string view_name;
+    std::vector<Condition> predicates;
+
+    SystemViewScanPlan(std::string view, std::vector<Condition> preds)
+        : view_name(std::move(view)), predicates(std::move(preds)) {
+        type = PlanType::SYSTEM_VIEW_SCAN;
+    }
+};
+
 // 3. 插入计划
 struct InsertPlan : Plan {
     std::string table_name;
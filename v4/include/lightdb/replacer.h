@@ -0,0 +1,178 @@
+#ifndef LIGHTDB_REPLACER_H
+#define LIGHTDB_REPLACER_H
+#include "base.h"
+#include "lightdb/page_table.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+namespace lightdb {
+    enum class ReplacerType {
+        LRU,
+        CLOCK,
+        CLOCK_PRO,
+        TWO_Q
+    };
+
+    // 访问类型：顺序扫描的访问不应让页面显得“热”
+    enum class AccessType {
+        NORMAL,
+        SEQUENTIAL
+    };
+
+    // 页面置换策略接口
+    // 帧编号为分区内的局部编号 [0, num_frames)，调用方需持有分区锁
+    class Replacer {
+        public:
+            virtual ~Replacer() = default;
+
+            virtual void RecordLoad(frame_id_t frame_id, PageID page_id, AccessType type) = 0; //页面被读入帧（未命中）
+            virtual void RecordAccess(frame_id_t frame_id, AccessType type) = 0; //缓冲区命中
+            // 选出淘汰帧；is_evictable 只对即将被选中的候选帧调用，用于跳过被 pin 住的帧
+            // 选中的帧不再被跟踪
+            virtual bool Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) = 0;
+            virtual void Remove(frame_id_t frame_id) = 0; //帧被直接释放（未经 Evict）
+            // 按预计的淘汰顺序列出最多 max_count 个候选帧（不改变置换器状态），供后台写线程提前清理脏页
+            virtual void GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const = 0;
+            // 可用帧数变化（缓冲池在线扩缩容）时调用，自适应参数按新帧数计算；帧编号的上限仍为构造时的帧数
+            virtual void SetCapacity(size_t /*num_frames*/) {}
+            // RecordAccess 能否在不持有分区锁时对已 pin 住的帧并发调用；能则缓冲池的命中路径完全无锁
+            virtual bool IsAccessThreadSafe() const { return false; }
+            virtual const char* Name() const = 0;
+    };
+
+    std::unique_ptr<Replacer> MakeReplacer(ReplacerType type, size_t num_frames);
+
+    // 经典 LRU：命中时移动到链表头，淘汰时从链表尾向前找
+    // 顺序访问载入的页直接放到链表尾，命中也不前移
+    class LRUReplacer : public Replacer {
+        public:
+            explicit LRUReplacer(size_t num_frames);
+
+            void RecordLoad(frame_id_t frame_id, PageID page_id, AccessType type) override;
+            void RecordAccess(frame_id_t frame_id, AccessType type) override;
+            bool Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) override;
+            void Remove(frame_id_t frame_id) override;
+            void GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const override;
+            const char* Name() const override { return "LRU"; }
+        private:
+            void PushFront(frame_id_t frame_id);
+            void PushBack(frame_id_t frame_id);
+            void Unlink(frame_id_t frame_id);
+
+            std::vector<frame_id_t> prev_;
+            std::vector<frame_id_t> next_;
+            std::vector<bool> in_list_;
+            frame_id_t head_ = INVALID_FRAME_ID; //最近使用
+            frame_id_t tail_ = INVALID_FRAME_ID; //最久未使用
+    };
+
+    // CLOCK：命中时只设置引用位，淘汰时时钟指针清除引用位直到找到未被引用的帧
+    // 顺序访问不设置引用位；引用位为原子量，命中时无需持有分区锁
+    class ClockReplacer : public Replacer {
+        public:
+            explicit ClockReplacer(size_t num_frames);
+
+            void RecordLoad(frame_id_t frame_id, PageID page_id, AccessType type) override;
+            void RecordAccess(frame_id_t frame_id, AccessType type) override;
+            bool Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) override;
+            void Remove(frame_id_t frame_id) override;
+            void GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const override;
+            bool IsAccessThreadSafe() const override { return true; }
+            const char* Name() const override { return "CLOCK"; }
+        private:
+            std::vector<std::atomic<uint8_t>> ref_bits_;
+            std::vector<bool> in_use_;
+            size_t hand_ = 0;
+    };
+
+    // CLOCK-Pro (Jiang et al., USENIX ATC 2005)
+    // 驻留页分为 hot/cold 两类，cold 页在测试期内被淘汰后保留为非驻留元数据，
+    // 测试期内再次访问则直接提升为 hot，从而识别出重用距离较短的页面；
+    // 冷页目标数 cold_target_ 根据测试期命中情况自适应调整；顺序访问载入的页不进入测试期
+    class ClockProReplacer : public Replacer {
+        public:
+            explicit ClockProReplacer(size_t num_frames);
+
+            void RecordLoad(frame_id_t frame_id, PageID page_id, AccessType type) override;
+            void RecordAccess(frame_id_t frame_id, AccessType type) override;
+            bool Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) override;
+            void Remove(frame_id_t frame_id) override;
+            void GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const override;
+            void SetCapacity(size_t num_frames) override;
+            const char* Name() const override { return "CLOCK-Pro"; }
+        private:
+            enum class State : uint8_t { FREE, HOT, COLD, NON_RESIDENT };
+            struct Entry {
+                PageID page_id = INVALID_PAGE_ID;
+                frame_id_t frame_id = INVALID_FRAME_ID;
+                State state = State::FREE;
+                bool ref = false;
+                bool test = false; //处于测试期
+                int prev = -1;
+                int next = -1;
+            };
+            int NewEntry(PageID page_id, frame_id_t frame_id, State state);
+            void InsertAtHead(int idx); //插入到 hand_hot_ 之前，即链表头
+            void Unlink(int idx); //从环上摘下，指向它的指针前移
+            void FreeEntry(int idx);
+            void MoveToHead(int idx);
+            bool RunHandHot(); //降级一个 hot 页时返回 true
+            void RunHandTest();
+            void Promote(int idx);
+
+            size_t capacity_;
+            size_t cold_target_;
+            size_t hot_count_ = 0;
+            size_t cold_count_ = 0;
+            size_t non_resident_count_ = 0;
+            std::vector<Entry> entries_;
+            std::vector<int> free_entries_;
+            std::vector<int> frame_entry_; //帧 -> 条目
+            PageTable history_; //非驻留页 PageID -> 条目
+            int hand_hot_ = -1;
+            int hand_cold_ = -1;
+            int hand_test_ = -1;
+    };
+
+    // 2Q (Johnson & Shasha, VLDB 1994)，LRU-2 的 O(1) 近似
+    // 首次载入的页进入 FIFO 队列 A1in，从 A1in 淘汰时只把 PageID 记入幽灵队列 A1out；
+    // 页面在 A1out 中被再次请求时才进入 LRU 队列 Am。一次性扫描的页只会在 A1in 中流过，
+    // 不会挤占 Am 中的热页。顺序访问载入的页被淘汰时不记入 A1out
+    class TwoQueueReplacer : public Replacer {
+        public:
+            explicit TwoQueueReplacer(size_t num_frames);
+
+            void RecordLoad(frame_id_t frame_id, PageID page_id, AccessType type) override;
+            void RecordAccess(frame_id_t frame_id, AccessType type) override;
+            bool Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) override;
+            void Remove(frame_id_t frame_id) override;
+            void GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const override;
+            void SetCapacity(size_t num_frames) override;
+            const char* Name() const override { return "2Q"; }
+        private:
+            enum Queue : uint8_t { NONE, A1IN, AM };
+            struct List {
+                frame_id_t head = INVALID_FRAME_ID;
+                frame_id_t tail = INVALID_FRAME_ID;
+                size_t size = 0;
+            };
+            void PushFront(List& list, Queue queue, frame_id_t frame_id);
+            void Unlink(frame_id_t frame_id);
+            bool EvictFrom(List& list, const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim);
+            void RememberEvicted(PageID page_id); //加入 A1out
+
+            size_t a1in_target_; //A1in 的目标长度 Kin
+            std::vector<frame_id_t> prev_;
+            std::vector<frame_id_t> next_;
+            std::vector<Queue> queue_;
+            std::vector<PageID> frame_page_;
+            std::vector<bool> sequential_;
+            List a1in_;
+            List am_;
+            std::vector<PageID> a1out_ring_; //A1out：定长环形 FIFO
+            size_t a1out_cursor_ = 0;
+            PageTable a1out_; //A1out 成员 PageID -> 环中位置
+    };
+}
+#endif
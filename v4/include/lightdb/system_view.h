@@ -0,0 +1,33 @@
+#ifndef LIGHTDB_SYSTEM_VIEW_H
+#define LIGHTDB_SYSTEM_VIEW_H
+
+#include "base.h"
+#include "buffer_pool.h"
+#include "buffer_pool_manager.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lightdb {
+
+// 系统视图：没有数据文件的只读表，每次扫描时由 scan 现场生成所有行
+struct SystemView {
+    std::string name;
+    std::vector<std::string> columns;
+    std::function<std::vector<Tuple>()> scan;
+};
+
+// 缓冲池统计视图 lightdb_buffer_pool_stats：每个分区一行，最后一行 partition 为 "total"
+// 列: partition, hits, misses, hit_ratio, evictions, evict_failures, frame_waits, frame_wait_timeouts,
+//     frame_wait_us, dirty_flushes, bg_writer_flushes, prefetched_pages, checksum_failures, lock_contended,
+//     lock_wait_us, miss_avg_us, miss_p50_us, miss_p99_us
+// pool 须比注册了该视图的 Catalog 活得久
+SystemView MakeBufferPoolStatsView(const BufferPool* pool);
+
+// 命名缓冲池视图 lightdb_buffer_pools：每个池一行
+// 列: pool, frames, partitions, replacer, hits, misses, hit_ratio, evictions, migrated_pages
+// manager 须比注册了该视图的 Catalog 活得久
+SystemView MakeBufferPoolsView(const BufferPoolManager* manager);
+
+} // namespace lightdb
+#endif
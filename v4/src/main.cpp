@@ -11,6 +11,7 @@
 #include "lightdb/parser.h"
 
 #include <cassert>
+#include <cstdio>
 #include <iostream>
 
 // 测试 Parser 函数
@@ -83,6 +84,10 @@ void TestPlanner(lightdb::Planner& planner, const std::string& sql) {
                         }
                     }
                     break;
+                case lightdb::PlanType::SYSTEM_VIEW_SCAN:
+                    plan_type = "Physical Plan: SystemViewScan [View: " +
+                                static_cast<lightdb::SystemViewScanPlan*>(plan.get())->view_name + "]";
+                    break;
                 case lightdb::PlanType::INSERT: plan_type = "Physical Plan: Insert"; break;
                 case lightdb::PlanType::CREATE_TABLE: plan_type = "Physical Plan: CreateTable"; break;
                 default: plan_type = "Physical Plan: Other"; break;
@@ -96,6 +101,22 @@ void TestPlanner(lightdb::Planner& planner, const std::string& sql) {
     }
     std::cout << "-----------------------------------" << std::endl;
 }
+// 输出系统视图的全部行
+void PrintSystemView(lightdb::Catalog& catalog, const std::string& view_name) {
+    lightdb::SystemView* view = catalog.GetSystemView(view_name);
+    std::string header;
+    for (const auto& column : view->columns) {
+        header += column + " ";
+    }
+    LOG_INFO(header);
+    for (const auto& row : view->scan()) {
+        std::string line;
+        for (const auto& field : row.fields) {
+            line += field + " ";
+        }
+        LOG_INFO(line);
+    }
+}
 int main() {
     // 初始化日志
     lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::DEBUG);
@@ -113,6 +134,12 @@ int main() {
 
     LOG_INFO("Stage 1 仓库初始化与基础框架搭建完成！");
 
+    // 清理上一次运行留下的数据文件，保证每次测试从空表开始
+    for (const char* path : {"test_table.db", "test_table.db.fsm", "test_index.db", "users.db", "users.db.fsm",
+                             "orders.db", "orders.db.fsm", "users_id.idx"}) {
+        std::remove(path);
+    }
+
     // 测试HeapFile
     lightdb::BufferPool buffer_pool(1024);  // 增大缓冲池
     lightdb::HeapFile heap_file("test_table.db", &buffer_pool);
@@ -126,7 +153,7 @@ int main() {
     LOG_INFO("SeqScan result: total " + std::to_string(records.size()) + " records");
 
     // 新增B+Tree测试
-    lightdb::BTreeIndex btree(&buffer_pool, 200);  // 阶数200
+    lightdb::BTreeIndex btree(&buffer_pool, "test_index.db", 200);  // 阶数200
     std::vector<lightdb::RID> test_rids;
 
     // 插入1万条数据
@@ -182,24 +209,36 @@ int main() {
     lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::INFO);
     LOG_INFO("Starting Stage 5: Query Planner & Optimizer Test");
 
-    // 1. 基础设施初始化
-    lightdb::BufferPool planner_buffer_pool(1024);
-    
-    // 2. 模拟系统目录 (Catalog)
+    // 1. 模拟系统目录 (Catalog)
     lightdb::Catalog catalog;
-    
+
+    // 2. 基础设施初始化：命名缓冲池共用一个 DiskManager，表放在默认池，OLTP 索引独占一个池
+    lightdb::DiskManager planner_disk_manager;
+    lightdb::BufferPoolManager pool_manager(&planner_disk_manager);
+    lightdb::BufferPool* default_pool = pool_manager.CreatePool("default", 1024);
+    lightdb::BufferPoolConfig index_pool_config;
+    index_pool_config.replacer = lightdb::ReplacerType::CLOCK;
+    pool_manager.CreatePool("oltp_index", 256, index_pool_config);
+    catalog.SetBufferPoolManager(&pool_manager);
+
     // 模拟表 "users"
-    lightdb::HeapFile user_heap("users.db", &buffer_pool);
+    lightdb::HeapFile user_heap("users.db", default_pool);
     catalog.RegisterTable("users", &user_heap);
     
     // 模拟表 "orders"
-    lightdb::HeapFile order_heap("orders.db", &buffer_pool);
+    lightdb::HeapFile order_heap("orders.db", default_pool);
     catalog.RegisterTable("orders", &order_heap);
 
     // *** 关键：只在 users 表的 id 字段上注册索引 ***
-    lightdb::BTreeIndex user_id_index(&buffer_pool);
+    lightdb::BTreeIndex user_id_index(default_pool, "users_id.idx");
     catalog.RegisterIndex("users", "id", &user_id_index);
     LOG_INFO("System Catalog Initialized: Index 'idx_users_id' created on users(id)");
+    // 索引在线改到 oltp_index 池，已缓存的节点页在下次访问时迁入
+    catalog.AssignIndexPool("users", "id", "oltp_index");
+    lightdb::RID found;
+    user_id_index.Search(0, found);
+    catalog.RegisterSystemView(lightdb::MakeBufferPoolStatsView(&buffer_pool));
+    catalog.RegisterSystemView(lightdb::MakeBufferPoolsView(&pool_manager));
 
     // 3. 初始化 Planner
     lightdb::Planner planner(&catalog);
@@ -222,5 +261,13 @@ int main() {
 
     // --- 测试用例 6: CREATE TABLE (预期: CreateTablePlan) ---
     TestPlanner(planner, "CREATE TABLE posts (id INT, title VARCHAR);");
+
+    // --- 测试用例 7: SELECT - 系统视图 (预期: SystemViewScan)，输出上面存储引擎测试的缓冲池统计 ---
+    TestPlanner(planner, "SELECT * FROM lightdb_buffer_pool_stats;");
+    PrintSystemView(catalog, "lightdb_buffer_pool_stats");
+
+    // --- 测试用例 8: SELECT - 命名缓冲池视图 (预期: SystemViewScan)，索引的根页已从 default 迁入 oltp_index ---
+    TestPlanner(planner, "SELECT * FROM lightdb_buffer_pools;");
+    PrintSystemView(catalog, "lightdb_buffer_pools");
     return 0;
 }
\ No newline at end of file
@@ -23,6 +23,12 @@ std::unique_ptr<Plan> Planner::PlanQuery(Statement* stmt) {
 // 规则：如果在 WHERE 子句中发现了有索引的列，优先生成 IndexScan，否则生成 SeqScan
 std::unique_ptr<Plan> Planner::PlanSelect(SelectStatement* stmt) {
     std::string table_name = stmt->table_name;
+
+    // 0. 系统视图没有数据文件和索引，直接扫描
+    if (catalog_->GetSystemView(table_name) != nullptr) {
+        LOG_INFO("Optimizer: " + table_name + " is a system view, using SystemViewScan.");
+        return std::make_unique<SystemViewScanPlan>(table_name, stmt->where_clauses);
+    }
     
     // 1. 检查是否有 WHERE 条件
     if (!stmt->where_clauses.empty()) {
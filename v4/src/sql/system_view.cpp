@@ -0,0 +1,82 @@
+#include "lightdb/system_view.h"
+#include <cstdio>
+
+namespace lightdb {
+
+namespace {
+Tuple StatsRow(const std::string& partition, const BufferPoolStats& stats) {
+    char hit_ratio[16];
+    std::snprintf(hit_ratio, sizeof(hit_ratio), "%.4f", stats.HitRatio());
+    Tuple row;
+    row.AddField(partition);
+    row.AddField(std::to_string(stats.hits));
+    row.AddField(std::to_string(stats.misses));
+    row.AddField(hit_ratio);
+    row.AddField(std::to_string(stats.evictions));
+    row.AddField(std::to_string(stats.evict_failures));
+    row.AddField(std::to_string(stats.frame_waits));
+    row.AddField(std::to_string(stats.frame_wait_timeouts));
+    row.AddField(std::to_string(stats.frame_wait_nanos / 1000));
+    row.AddField(std::to_string(stats.dirty_flushes));
+    row.AddField(std::to_string(stats.bg_writer_flushes));
+    row.AddField(std::to_string(stats.prefetched_pages));
+    row.AddField(std::to_string(stats.checksum_failures));
+    row.AddField(std::to_string(stats.lock_contended));
+    row.AddField(std::to_string(stats.lock_wait_nanos / 1000));
+    row.AddField(std::to_string(stats.misses == 0 ? 0 : stats.miss_nanos / stats.misses / 1000));
+    row.AddField(std::to_string(stats.MissLatencyPercentileMicros(0.5)));
+    row.AddField(std::to_string(stats.MissLatencyPercentileMicros(0.99)));
+    return row;
+}
+} // namespace
+
+SystemView MakeBufferPoolStatsView(const BufferPool* pool) {
+    SystemView view;
+    view.name = "lightdb_buffer_pool_stats";
+    view.columns = {"partition", "hits", "misses", "hit_ratio", "evictions", "evict_failures", "frame_waits",
+                    "frame_wait_timeouts", "frame_wait_us", "dirty_flushes", "bg_writer_flushes", "prefetched_pages",
+                    "checksum_failures", "lock_contended", "lock_wait_us", "miss_avg_us", "miss_p50_us", "miss_p99_us"};
+    view.scan = [pool]() {
+        std::vector<Tuple> rows;
+        BufferPoolStats total;
+        for (int i = 0; i < pool->GetNumPartitions(); i++) {
+            BufferPoolStats stats = pool->GetPartitionStats(i);
+            rows.push_back(StatsRow(std::to_string(i), stats));
+            total += stats;
+        }
+        rows.push_back(StatsRow("total", total));
+        return rows;
+    };
+    return view;
+}
+
+SystemView MakeBufferPoolsView(const BufferPoolManager* manager) {
+    SystemView view;
+    view.name = "lightdb_buffer_pools";
+    view.columns = {"pool", "frames", "partitions", "replacer", "hits", "misses", "hit_ratio", "evictions",
+                    "migrated_pages"};
+    view.scan = [manager]() {
+        std::vector<Tuple> rows;
+        for (const auto& entry : manager->GetPools()) {
+            const BufferPool* pool = entry.second;
+            BufferPoolStats stats = pool->GetStats();
+            char hit_ratio[16];
+            std::snprintf(hit_ratio, sizeof(hit_ratio), "%.4f", stats.HitRatio());
+            Tuple row;
+            row.AddField(entry.first);
+            row.AddField(std::to_string(pool->GetMaxFrames()));
+            row.AddField(std::to_string(pool->GetNumPartitions()));
+            row.AddField(pool->GetReplacerName());
+            row.AddField(std::to_string(stats.hits));
+            row.AddField(std::to_string(stats.misses));
+            row.AddField(hit_ratio);
+            row.AddField(std::to_string(stats.evictions));
+            row.AddField(std::to_string(stats.migrated_pages));
+            rows.push_back(row);
+        }
+        return rows;
+    };
+    return view;
+}
+
+} // namespace lightdb
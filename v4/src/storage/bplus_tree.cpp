@@ -1,6 +1,7 @@
 #include "lightdb/bplus_tree.h"
 #include "lightdb/logger.h"
 #include <cstring>
+#include <limits>
 
 namespace lightdb {
 
@@ -75,13 +76,125 @@ void BTreeInternalNode::Deserialize(const char* data) {
     }
 }
 
+BTreeIndex::BTreeIndex(BufferPool* bp, const std::string& file_path, int order, StorageMode mode,
+                       PageCompression compression)
+    : buffer_pool_(bp), root_page_id_(INVALID_PAGE_ID), order_(order), next_page_id_(0), mode_(mode),
+      compression_(compression) {
+    if (mode_ == StorageMode::MMAP_READ_ONLY && compression_ != PageCompression::NONE) {
+        LOG_WARN("Index file " + file_path + " is compressed and cannot be mapped, using the buffer pool");
+        mode_ = StorageMode::BUFFER_POOL;
+    }
+    file_id_ = buffer_pool_->GetDiskManager()->OpenFile(file_path, compression_);
+    if (mode_ == StorageMode::MMAP_READ_ONLY) {
+        mmap_file_ = std::make_unique<MmapFile>(file_path);
+        // 索引点查与范围扫描都是随机访问，关闭内核预读
+        mmap_file_->Advise(MmapAdvice::RANDOM);
+        if (!LoadMeta()) {
+            LOG_ERROR("Index file " + file_path + " has no valid meta page");
+        }
+        return;
+    }
+    if (buffer_pool_->GetDiskManager()->GetNumPages(file_id_) > 0 && LoadMeta()) {
+        next_page_id_ = buffer_pool_->GetDiskManager()->GetNumPages(file_id_);
+        return;
+    }
+    // 新树：第 0 页为元数据页，根节点从第 1 页开始
+    next_page_id_ = META_PAGE_NO + 1;
+    root_page_id_ = AllocatePage();
+    auto root = std::make_unique<BTreeLeafNode>(root_page_id_);
+    SaveNode(root.get());
+    SaveMeta();
+}
+
+bool BTreeIndex::SetBufferPool(BufferPool* bp) {
+    std::unique_lock<std::shared_mutex> lock(pool_latch_);
+    if (bp == buffer_pool_) {
+        return true;
+    }
+    if (bp->GetDiskManager() != buffer_pool_->GetDiskManager()) {
+        LOG_ERROR("SetBufferPool failed: index file " + std::to_string(file_id_) + " is open in another DiskManager");
+        return false;
+    }
+    if (!bp->AdoptFile(file_id_, buffer_pool_)) {
+        return false;
+    }
+    buffer_pool_ = bp;
+    LOG_INFO("Index file " + std::to_string(file_id_) + " switched to another buffer pool");
+    return true;
+}
+
+BufferPool* BTreeIndex::GetBufferPool() {
+    std::shared_lock<std::shared_mutex> lock(pool_latch_);
+    return buffer_pool_;
+}
+
+bool BTreeIndex::LoadMeta() {
+    BTreeMeta meta;
+    if (mode_ == StorageMode::MMAP_READ_ONLY) {
+        const char* data = mmap_file_->GetPage(META_PAGE_NO);
+        if (data == nullptr) return false;
+        memcpy(&meta, data, sizeof(BTreeMeta));
+    } else {
+        ReadPageGuard guard = buffer_pool_->FetchPageRead(MakePageID(file_id_, META_PAGE_NO));
+        if (!guard) return false;
+        memcpy(&meta, guard.GetData(), sizeof(BTreeMeta));
+    }
+    if (meta.magic != META_MAGIC) return false;
+    root_page_id_ = MakePageID(file_id_, meta.root_page_no);
+    return true;
+}
+
+void BTreeIndex::SaveMeta() {
+    WritePageGuard guard = buffer_pool_->FetchPageWrite(MakePageID(file_id_, META_PAGE_NO));
+    if (!guard) {
+        LOG_ERROR("Failed to save index meta page");
+        return;
+    }
+    BTreeMeta meta{META_MAGIC, GetPageNo(root_page_id_)};
+    memcpy(guard.GetDataMut(), &meta, sizeof(BTreeMeta));
+}
+
 // BTreeIndex 辅助函数
 std::unique_ptr<BTreeNode> BTreeIndex::FetchNode(PageID pid) {
     if (pid == INVALID_PAGE_ID) return nullptr;
-    Page* page = buffer_pool_->FetchPage(pid);
-    if (!page) return nullptr;
+    // 节点中保存的 PageID 带有写入时的文件编号，按本次打开的文件编号重新组合
+    pid = MakePageID(file_id_, GetPageNo(pid));
+    const char* data = nullptr;
+    ReadPageGuard guard;
+    if (mode_ == StorageMode::MMAP_READ_ONLY) {
+        // 映射模式：直接在映射内存上反序列化
+        data = mmap_file_->GetPage(GetPageNo(pid));
+        if (data == nullptr) return nullptr;
+    } else {
+        guard = buffer_pool_->FetchPageRead(pid);
+        if (!guard) return nullptr;
+        data = guard.GetData();
+    }
+
+    return DecodeNode(pid, data);
+}
 
-    const char* data = page->GetData();
+std::vector<std::unique_ptr<BTreeNode>> BTreeIndex::FetchNodes(const std::vector<PageID>& pids) {
+    std::vector<std::unique_ptr<BTreeNode>> nodes;
+    if (mode_ == StorageMode::MMAP_READ_ONLY) {
+        for (PageID pid : pids) {
+            nodes.push_back(FetchNode(pid));
+        }
+        return nodes;
+    }
+    std::vector<PageID> page_ids;
+    page_ids.reserve(pids.size());
+    for (PageID pid : pids) {
+        page_ids.push_back(MakePageID(file_id_, GetPageNo(pid)));
+    }
+    std::vector<ReadPageGuard> guards = buffer_pool_->FetchPagesRead(page_ids);
+    for (size_t i = 0; i < guards.size(); i++) {
+        nodes.push_back(guards[i] ? DecodeNode(page_ids[i], guards[i].GetData()) : nullptr);
+    }
+    return nodes;
+}
+
+std::unique_ptr<BTreeNode> BTreeIndex::DecodeNode(PageID pid, const char* data) {
     bool is_leaf = data[0] == 1;
     std::unique_ptr<BTreeNode> node;
 
@@ -91,29 +204,32 @@ std::unique_ptr<BTreeNode> BTreeIndex::FetchNode(PageID pid) {
         node = std::make_unique<BTreeInternalNode>(pid);
     }
     node->Deserialize(data);
-    buffer_pool_->UnpinPage(pid, false);
     return node;
 }
 
 void BTreeIndex::SaveNode(const BTreeNode* node) {
-    Page* page = buffer_pool_->FetchPage(node->page_id);
-    if (!page) {
+    WritePageGuard guard = buffer_pool_->FetchPageWrite(node->page_id);
+    if (!guard) {
         LOG_ERROR("Failed to save node: page " + std::to_string(node->page_id) + " not found");
         return;
     }
-    node->Serialize(page->GetData());
-    buffer_pool_->UnpinPage(node->page_id, true); // 标记脏页
+    node->Serialize(guard.GetDataMut()); // 标记脏页
 }
 
 PageID BTreeIndex::AllocatePage() {
-    return next_page_id_++;
+    return MakePageID(file_id_, next_page_id_++);
 }
 
 // 插入实现
 bool BTreeIndex::Insert(const KeyType& key, const ValueType& value) {
+    std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
     KeyType split_key;
     PageID new_page_id = INVALID_PAGE_ID;
 
+    if (mode_ == StorageMode::MMAP_READ_ONLY) {
+        LOG_ERROR("Insert failed: index is read-only");
+        return false;
+    }
     if (InsertHelper(root_page_id_, key, value, split_key, new_page_id)) {
         // 根节点分裂需要创建新根
         if (new_page_id != INVALID_PAGE_ID) {
@@ -137,6 +253,7 @@ bool BTreeIndex::Insert(const KeyType& key, const ValueType& value) {
             // 保存新根
             SaveNode(new_root.get());
             root_page_id_ = new_root_id;
+            SaveMeta();
         }
         return true;
     }
@@ -281,6 +398,7 @@ void BTreeIndex::SplitInternalNode(const BTreeInternalNode* internal, BTreeInter
 
 // 查找实现
 bool BTreeIndex::Search(const KeyType& key, ValueType& value) {
+    std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
     PageID current = root_page_id_;
     while (current != INVALID_PAGE_ID) {
         auto node = FetchNode(current);
@@ -308,7 +426,7 @@ bool BTreeIndex::Search(const KeyType& key, ValueType& value) {
 }
 
 // 范围扫描实现
-PageID BTreeIndex::FindFirstLeaf(const KeyType& key) {
+PageID BTreeIndex::FindFirstLeaf(const KeyType& key, std::vector<PageID>* next_leaves) {
     PageID current = root_page_id_;
     while (current != INVALID_PAGE_ID) {
         auto node = FetchNode(current);
@@ -323,35 +441,80 @@ PageID BTreeIndex::FindFirstLeaf(const KeyType& key) {
                 pos++;
             }
             current = internal->children[pos];
+            if (next_leaves != nullptr) {
+                // 最后经过的内部节点即叶子的父节点，其后的孩子就是兄弟叶子
+                next_leaves->assign(internal->children.begin() + pos + 1, internal->children.end());
+            }
         }
     }
     return INVALID_PAGE_ID;
 }
 
 std::vector<ValueType> BTreeIndex::RangeScan(const KeyType& start, const KeyType& end) {
+    std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
     std::vector<ValueType> result;
-    PageID current_pid = FindFirstLeaf(start);
-
+    // 叶子按批读取：批内的叶子取自父节点中的兄弟叶子，第一批只读一个（范围通常很窄），之后每批加倍
+    // 兄弟叶子用完后沿 next 指针进入下一个父节点，并重新下降一次取得新的兄弟叶子
+    std::vector<PageID> next_leaves;
+    size_t next = 0;
+    PageID current_pid = FindFirstLeaf(start, &next_leaves);
+    size_t batch_size = 1;
+    std::vector<PageID> batch;
     while (current_pid != INVALID_PAGE_ID) {
-        auto node = FetchNode(current_pid);
-        if (!node || !node->is_leaf) break;
-
-        auto* leaf = static_cast<BTreeLeafNode*>(node.get());
-        // 收集当前叶子中符合条件的记录
-        for (const auto& entry : leaf->entries) {
-            if (entry.first > end) break;
-            if (entry.first >= start) {
-                result.push_back(entry.second);
+        batch.assign(1, current_pid);
+        while (batch.size() < batch_size && next < next_leaves.size()) {
+            batch.push_back(next_leaves[next++]);
+        }
+        bool done = false;
+        PageID following = INVALID_PAGE_ID;
+        KeyType last_key = start;
+        for (const auto& node : FetchNodes(batch)) {
+            if (!node || !node->is_leaf) {
+                done = true;
+                break;
             }
+            auto* leaf = static_cast<BTreeLeafNode*>(node.get());
+            // 收集当前叶子中符合条件的记录
+            for (const auto& entry : leaf->entries) {
+                if (entry.first > end) {
+                    done = true;
+                    break;
+                }
+                if (entry.first >= start) {
+                    result.push_back(entry.second);
+                }
+                last_key = entry.first;
+            }
+            if (done) break;
+            following = leaf->next;
         }
+        if (done) break;
 
-        current_pid = leaf->next;
+        if (next < next_leaves.size()) {
+            current_pid = next_leaves[next++];
+        } else {
+            current_pid = following;
+            next_leaves.clear();
+            next = 0;
+            // 只有下降找到的叶子与 next 指针一致时才使用新的兄弟叶子
+            std::vector<PageID> siblings;
+            if (following != INVALID_PAGE_ID && last_key < std::numeric_limits<KeyType>::max() &&
+                GetPageNo(FindFirstLeaf(last_key + 1, &siblings)) == GetPageNo(following)) {
+                next_leaves.swap(siblings);
+            }
+        }
+        batch_size = std::min(batch_size * 2, static_cast<size_t>(RANGE_SCAN_BATCH));
     }
     return result;
 }
 
 // 删除实现（简化版，仅处理基础删除逻辑，未实现合并）
 bool BTreeIndex::Delete(const KeyType& key) {
+    std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
+    if (mode_ == StorageMode::MMAP_READ_ONLY) {
+        LOG_ERROR("Delete failed: index is read-only");
+        return false;
+    }
     return DeleteHelper(root_page_id_, key);
 }
 
@@ -1,96 +1,1332 @@
 #include "lightdb/buffer_pool.h"
 #include <iostream>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 namespace lightdb {
-    Page* BufferPool::FetchPage(PageID page_id) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = frame_map_.find(page_id);
-        if (it != frame_map_.end()) {
-            UpdateLRU(it->second.page.page_id);
-            it->second.pin_count++;
-            LOG_DEBUG("Fetch page " + std::to_string(page_id) + " from buffer");
-            return &it->second.page;
-        }
-
-        // 页面不在缓冲区，需要加载
-        if (frame_map_.size() >= max_frames) {
-            EvictLRU();
-        }
-
-        // 初始化新帧
-        Frame new_frame;
-        new_frame.page.page_id = page_id;
-        new_frame.is_dirty = false;
-        new_frame.pin_count = 1;
-        // 插入 LRU 链表头部
-        lru_list_.push_front(page_id);
-        new_frame.lru_iter = lru_list_.begin(); // 绑定迭代器
-        // 存入映射
-        frame_map_[page_id] = new_frame;
+    BufferPool::BufferPool(int max_frames, DiskManager* disk_manager, const BufferPoolConfig& config)
+        : max_frames(max_frames), capacity_frames_(std::max(max_frames, config.max_pool_frames)), config_(config),
+          disk_manager_(disk_manager),
+          page_arena_(std::make_unique<MemoryArena>(static_cast<size_t>(capacity_frames_) * PAGE_SIZE,
+                                                    config.huge_pages, false)),
+          frames_(new Frame[capacity_frames_]), recent_writes_(new std::atomic<PageID>[RECENT_WRITE_SLOTS]) {
+        for (size_t i = 0; i < RECENT_WRITE_SLOTS; i++) {
+            recent_writes_[i].store(INVALID_PAGE_ID, std::memory_order_relaxed);
+        }
+        if (disk_manager_ == nullptr) {
+            owned_disk_manager_ = std::make_unique<DiskManager>(false, config.io_engine);
+            disk_manager_ = owned_disk_manager_.get();
+        }
+        for (int fid = 0; fid < capacity_frames_; fid++) {
+            frames_[fid].page.data = page_arena_->Data() + static_cast<size_t>(fid) * PAGE_SIZE;
+        }
+        // 超出初始帧数的部分只保留虚拟地址，扩容后首次使用时才分配物理内存
+        if (config.prefault_arena) {
+            page_arena_->Populate(0, static_cast<size_t>(max_frames) * PAGE_SIZE);
+        }
+        RegisterFrames(max_frames);
+        // 分区数不超过帧数，保证每个分区至少有一个帧
+        int num_partitions = std::max(1, std::min(config.num_partitions, max_frames));
+        for (int i = 0; i < num_partitions; i++) {
+            frame_id_t part_capacity = (capacity_frames_ - i + num_partitions - 1) / num_partitions;
+            auto part = std::make_unique<Partition>(part_capacity, config.replacer);
+            for (frame_id_t local = 0; local < part_capacity; local++) {
+                part->frames.push_back(local * num_partitions + i);
+                frames_[local * num_partitions + i].retired = true;
+            }
+            partitions_.push_back(std::move(part));
+        }
+        for (int i = 0; i < num_partitions; i++) {
+            // 初始时可用帧都空闲
+            SetActiveFrames(*partitions_[i], (max_frames - i + num_partitions - 1) / num_partitions);
+        }
+        if (config_.background_writer) {
+            bg_writer_ = std::thread(&BufferPool::BackgroundWriterLoop, this);
+        }
+    }
+    BufferPool::~BufferPool() {
+        // 等待在途的预读完成，其完成回调会访问帧和分区
+        for (auto& part : partitions_) {
+            std::unique_lock<std::mutex> lock(part->mutex);
+            part->io_done.wait(lock, [&part]() { return part->reads_in_flight == 0; });
+        }
+        if (resize_thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(resize_mutex_);
+                resize_stop_ = true;
+            }
+            resize_cv_.notify_all();
+            resize_thread_.join();
+        }
+        if (bg_writer_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(bg_writer_mutex_);
+                bg_writer_stop_ = true;
+            }
+            bg_writer_cv_.notify_all();
+            bg_writer_.join();
+        }
+        // 所有脏页按 PageID 排序后合并写回；与之前一样不做 fdatasync，由调用方决定是否同步
+        FlushAll(false);
+        // 外部传入的 DiskManager 比缓冲池活得久，页内存区解除映射后其地址可能被复用，必须注销
+        disk_manager_->UnregisterBufferRegion(page_arena_->Data(), page_arena_->Size());
+    }
+    BufferAccessStrategy::BufferAccessStrategy(const BufferPool& pool, int ring_pages) {
+        // 环按分区均分，每个分区的环不超过该分区帧数的 1/4
+        int num_partitions = pool.GetNumPartitions();
+        max_ring_per_partition_ = std::max(1, pool.GetMaxFrames() / num_partitions / 4);
+        int per_partition = std::min(std::max(1, ring_pages / num_partitions), max_ring_per_partition_);
+        read_ahead_.initial_window = std::max(1, pool.GetConfig().read_ahead_initial_pages);
+        read_ahead_.max_window = std::max(read_ahead_.initial_window, pool.GetConfig().read_ahead_max_pages);
+        verify_ = pool.GetConfig().verify_checksums;
+        rings_.resize(num_partitions);
+        for (auto& ring : rings_) {
+            ring.pages.assign(per_partition, INVALID_PAGE_ID);
+        }
+    }
+    size_t BufferPool::GetPartitionIndex(PageID page_id) const {
+        // 与页表使用不同的哈希位，避免分区内页表槽位分布退化
+        uint64_t key = static_cast<uint32_t>(page_id);
+        uint64_t hash = (key * 0xC2B2AE3D27D4EB4Full) >> 32;
+        return hash % partitions_.size();
+    }
+    std::unique_lock<std::mutex> BufferPool::LockPartition(Partition& part) {
+        PartitionStats::Add(part.stats.lock_acquisitions);
+        std::unique_lock<std::mutex> lock(part.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            auto start = std::chrono::steady_clock::now();
+            lock.lock();
+            PartitionStats::Add(part.stats.lock_contended);
+            PartitionStats::Add(part.stats.lock_wait_nanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                                 std::chrono::steady_clock::now() - start).count());
+        }
+        return lock;
+    }
+    BufferPoolStats BufferPool::GetStats() const {
+        BufferPoolStats total;
+        for (const auto& part : partitions_) {
+            total += part->stats.Snapshot();
+        }
+        return total;
+    }
+    BufferPoolStats BufferPool::GetPartitionStats(int part_idx) const {
+        if (part_idx < 0 || part_idx >= GetNumPartitions()) {
+            return BufferPoolStats();
+        }
+        return partitions_[part_idx]->stats.Snapshot();
+    }
+    void BufferPool::ResetStats() {
+        for (auto& part : partitions_) {
+            part->stats.Reset();
+        }
+    }
+    void BufferAccessStrategy::EnableReadAhead(FileID file_id, int32_t end_page_no) {
+        read_ahead_.enabled = true;
+        read_ahead_.file_id = file_id;
+        read_ahead_.end_page_no = end_page_no;
+        read_ahead_.last_page_no = -1;
+        read_ahead_.next_page_no = 0;
+        // 环至少能容纳两个窗口，否则预读的页可能在被消费前就被环复用；缓冲池太小时反过来限制窗口
+        int num_rings = static_cast<int>(rings_.size());
+        int per_partition = std::min(max_ring_per_partition_, 2 * read_ahead_.max_window / num_rings + 1);
+        for (auto& ring : rings_) {
+            if (static_cast<int>(ring.pages.size()) < per_partition) {
+                ring.pages.resize(per_partition, INVALID_PAGE_ID);
+            }
+        }
+        int ring_total = static_cast<int>(rings_[0].pages.size()) * num_rings;
+        read_ahead_.max_window = std::max(1, std::min(read_ahead_.max_window, ring_total / 2));
+        read_ahead_.window = std::min(read_ahead_.initial_window, read_ahead_.max_window);
+    }
+    Page* BufferPool::FetchPage(PageID page_id, BufferAccessStrategy* strategy) {
+        bool hit = false;
+        bool waited = false;
+        Page* page = FetchPageImpl(page_id, strategy, &hit, &waited);
+        // 预读会访问其他分区，须在释放本分区锁之后进行
+        if (page != nullptr && strategy != nullptr && strategy->read_ahead_.enabled) {
+            ReadAheadAfter(page_id, *strategy, hit, waited);
+        }
+        return page;
+    }
+    Page* BufferPool::FetchPageImpl(PageID page_id, BufferAccessStrategy* strategy, bool* hit, bool* waited) {
+        size_t part_idx = GetPartitionIndex(page_id);
+        Partition& part = *partitions_[part_idx];
+        AccessType access_type = strategy != nullptr ? AccessType::SEQUENTIAL : AccessType::NORMAL;
+        if (part.lock_free_hits) {
+            Frame* frame = TryPinLockFree(part, page_id, access_type);
+            if (frame != nullptr) {
+                PartitionStats::Add(part.stats.hits);
+                *hit = true;
+                return &frame->page;
+            }
+        }
+        // 未命中，或无锁路径遇到并发修改/读进行中的页：加锁后重新查找
+        std::unique_lock<std::mutex> lock = LockPartition(part);
+        frame_id_t fid;
+        std::chrono::steady_clock::time_point miss_start;
+        std::chrono::steady_clock::time_point wait_start;
+        bool frame_wait = false;
+        bool miss_started = false;
+        VictimWrite victim;
+        while (true) {
+            while (part.page_table.Find(page_id, &fid)) {
+                Frame& frame = GetFrame(part, fid);
+                if (frame.read_in_progress) {
+                    // 页面正在预读，等待读完成后重新查找（读失败时帧会被释放）
+                    *waited = true;
+                    part.io_done.wait(lock);
+                    continue;
+                }
+                part.replacer->RecordAccess(fid, access_type);
+                frame.pin_count.fetch_add(1, std::memory_order_acquire); //持锁时帧不会处于独占状态
+                PartitionStats::Add(part.stats.hits);
+                *hit = true;
+                LOG_DEBUG("Fetch page " + std::to_string(page_id) + " from buffer");
+                return &frame.page;
+            }
+
+            // 页面不在缓冲区，需要加载；服务时间包括分配（可能含淘汰脏页的写盘、等待可用帧）和读盘
+            if (!miss_started) {
+                miss_started = true;
+                miss_start = std::chrono::steady_clock::now();
+            }
+            fid = AllocateFrame(part, part_idx, strategy, &victim);
+            if (victim.Pending()) {
+                // 淘汰选中了脏页：在锁外写出后重新查找，期间页可能已被他人读入
+                WriteVictim(part, lock, &victim);
+                continue;
+            }
+            if (fid != INVALID_FRAME_ID) {
+                break;
+            }
+            // 无帧可用：等待其他线程 unpin，唤醒后页面可能已被他人读入，回到开头重新查找
+            if (config_.frame_wait_timeout_ms == 0) {
+                PartitionStats::Add(part.stats.misses);
+                LOG_ERROR("Fetch page " + std::to_string(page_id) + " failed: all frames are pinned");
+                return nullptr;
+            }
+            if (!frame_wait) {
+                frame_wait = true;
+                wait_start = std::chrono::steady_clock::now();
+                PartitionStats::Add(part.stats.frame_waits);
+            }
+            auto deadline = wait_start + std::chrono::milliseconds(config_.frame_wait_timeout_ms);
+            if (!WaitForFrame(part, part_idx, strategy, lock, deadline, &fid, &victim)) {
+                PartitionStats::Add(part.stats.misses);
+                PartitionStats::Add(part.stats.frame_wait_timeouts);
+                PartitionStats::Add(part.stats.frame_wait_nanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                                     std::chrono::steady_clock::now() - wait_start).count());
+                LOG_ERROR("Fetch page " + std::to_string(page_id) + " failed: all frames are pinned");
+                return nullptr;
+            }
+            if (victim.Pending()) {
+                WriteVictim(part, lock, &victim);
+                continue;
+            }
+            if (fid != INVALID_FRAME_ID) {
+                break;
+            }
+        }
+        PartitionStats::Add(part.stats.misses);
+        if (frame_wait) {
+            PartitionStats::Add(part.stats.frame_wait_nanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                                 std::chrono::steady_clock::now() - wait_start).count());
+        }
+
+        // 初始化帧后在锁外读盘；读完成前其他访问者会看到 read_in_progress 并等待
+        Frame& frame = GetFrame(part, fid);
+        frame.page.page_id = page_id;
+        frame.page.pin_count = 0;
+        frame.page.is_dirty = false;
+        frame.is_dirty = false;
+        ChecksumVerify verify = strategy != nullptr ? strategy->verify_ : config_.verify_checksums;
+        if (!LoadPage(part, lock, fid, page_id, access_type, verify)) {
+            return nullptr;
+        }
+        if (strategy != nullptr) {
+            auto& ring = strategy->rings_[part_idx];
+            ring.pages[ring.cursor] = page_id;
+            ring.cursor = (ring.cursor + 1) % ring.pages.size();
+        }
+        uint64_t miss_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now() - miss_start).count();
+        PartitionStats::Add(part.stats.miss_nanos, miss_nanos);
+        part.stats.miss_latency.Record(miss_nanos);
 
         LOG_DEBUG("Load page " + std::to_string(page_id) + " from disk");
-        return &frame_map_[page_id].page;
+        return &frame.page;
     }
-    void BufferPool::UnpinPage(PageID page_id, bool is_dirty)  {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = frame_map_.find(page_id);
-        if(it == frame_map_.end()) {
-            LOG_ERROR("UnpinPage: Page " + std::to_string(page_id) + " not found");
+    ReadPageGuard BufferPool::FetchPageRead(PageID page_id, BufferAccessStrategy* strategy) {
+        Page* page = FetchPage(page_id, strategy);
+        if (page == nullptr) {
+            return ReadPageGuard();
+        }
+        // 在分区锁之外加闩：已 pin 住的帧不会被淘汰，等闩期间不阻塞同分区的其他页
+        page->latch.lock_shared();
+        return ReadPageGuard(this, page);
+    }
+    WritePageGuard BufferPool::FetchPageWrite(PageID page_id, BufferAccessStrategy* strategy) {
+        Page* page = FetchPage(page_id, strategy);
+        if (page == nullptr) {
+            return WritePageGuard();
+        }
+        page->latch.lock();
+        return WritePageGuard(this, page);
+    }
+    std::vector<Page*> BufferPool::FetchPages(const std::vector<PageID>& page_ids, BufferAccessStrategy* strategy) {
+        struct PendingRead {
+            size_t index; //在 page_ids 中的位置
+            size_t part_idx;
+            frame_id_t fid;
+            int read_slot; //在 reads 中的位置，从其他缓冲池迁入的页为 -1
+            bool dirty;
+        };
+        std::vector<Page*> pages(page_ids.size(), nullptr);
+        std::vector<bool> hits(page_ids.size(), false);
+        std::vector<PendingRead> pending;
+        std::vector<size_t> waits; //页正由他人（或本批中同一页的前一次出现）读入，或暂时无帧可用，之后再逐页取
+        AccessType access_type = strategy != nullptr ? AccessType::SEQUENTIAL : AccessType::NORMAL;
+        ChecksumVerify verify = strategy != nullptr ? strategy->verify_ : config_.verify_checksums;
+
+        // 按分区分组，组内保持原有顺序
+        std::vector<std::vector<size_t>> by_partition(partitions_.size());
+        for (size_t i = 0; i < page_ids.size(); i++) {
+            by_partition[GetPartitionIndex(page_ids[i])].push_back(i);
+        }
+
+        // 1. 每个分区加一次锁：命中的页直接 pin，未命中的页分配帧并像预读一样登记为读进行中
+        auto miss_start = std::chrono::steady_clock::now();
+        for (size_t part_idx = 0; part_idx < partitions_.size(); part_idx++) {
+            if (by_partition[part_idx].empty()) {
+                continue;
+            }
+            Partition& part = *partitions_[part_idx];
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            for (size_t i : by_partition[part_idx]) {
+                PageID page_id = page_ids[i];
+                frame_id_t fid;
+                if (part.page_table.Find(page_id, &fid)) {
+                    Frame& frame = GetFrame(part, fid);
+                    if (frame.read_in_progress) {
+                        waits.push_back(i);
+                        continue;
+                    }
+                    part.replacer->RecordAccess(fid, access_type);
+                    frame.pin_count.fetch_add(1, std::memory_order_acquire);
+                    PartitionStats::Add(part.stats.hits);
+                    hits[i] = true;
+                    pages[i] = &frame.page;
+                    continue;
+                }
+                fid = AllocateFrame(part, part_idx, strategy, nullptr);
+                if (fid == INVALID_FRAME_ID) {
+                    waits.push_back(i); //无干净的帧可用，留到最后逐页取，那时会写出脏页或等待其他线程 unpin
+                    continue;
+                }
+                PartitionStats::Add(part.stats.misses);
+                Frame& frame = GetFrame(part, fid);
+                frame.page.page_id = page_id;
+                frame.page.pin_count = 0;
+                frame.page.is_dirty = false;
+                frame.is_dirty = false;
+                frame.read_in_progress = true;
+                frame.pin_count.store(0, std::memory_order_release);
+                part.reads_in_flight++;
+                part.page_table.Insert(page_id, fid);
+                part.replacer->RecordLoad(fid, page_id, access_type);
+                if (strategy != nullptr) {
+                    auto& ring = strategy->rings_[part_idx];
+                    ring.pages[ring.cursor] = page_id;
+                    ring.cursor = (ring.cursor + 1) % ring.pages.size();
+                }
+                pending.push_back({i, part_idx, fid, -1, false});
+            }
+        }
+
+        // 2. 不持锁：正在迁入本池的文件页先向 peer 取，其余的整批读盘
+        std::vector<PageIO> reads;
+        for (PendingRead& read : pending) {
+            PageID page_id = page_ids[read.index];
+            char* data = GetFrame(*partitions_[read.part_idx], read.fid).page.GetData();
+            if (IsMigrating(GetFileID(page_id)) && MigrateFromPeers(page_id, data, &read.dirty)) {
+                continue;
+            }
+            read.read_slot = static_cast<int>(reads.size());
+            reads.push_back({page_id, data});
+        }
+        if (!reads.empty()) {
+            disk_manager_->ReadPages(reads);
+        }
+
+        // 3. 每个分区再加一次锁：校验读入的页，pin 住并清除读标记（pending 已按分区顺序排列）
+        uint64_t miss_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now() - miss_start).count();
+        for (size_t begin = 0; begin < pending.size();) {
+            size_t part_idx = pending[begin].part_idx;
+            Partition& part = *partitions_[part_idx];
+            size_t end = begin;
+            {
+                std::unique_lock<std::mutex> lock = LockPartition(part);
+                for (; end < pending.size() && pending[end].part_idx == part_idx; end++) {
+                    const PendingRead& read = pending[end];
+                    PageID page_id = page_ids[read.index];
+                    Frame& frame = GetFrame(part, read.fid);
+                    part.reads_in_flight--;
+                    bool ok = read.read_slot < 0 ||
+                              (reads[read.read_slot].ok && VerifyRead(part, page_id, frame.page.GetData(), verify));
+                    if (!ok) {
+                        LOG_ERROR("Fetch page " + std::to_string(page_id) + " failed");
+                        part.replacer->Remove(read.fid);
+                        part.page_table.Erase(page_id);
+                        frame.page.page_id = INVALID_PAGE_ID;
+                        ReleaseFrame(part, read.fid);
+                    } else {
+                        if (read.read_slot < 0) {
+                            PartitionStats::Add(part.stats.migrated_pages);
+                            if (read.dirty) {
+                                frame.is_dirty.store(true, std::memory_order_relaxed);
+                            }
+                        }
+                        frame.pin_count.fetch_add(1, std::memory_order_acquire);
+                        pages[read.index] = &frame.page;
+                        PartitionStats::Add(part.stats.miss_nanos, miss_nanos);
+                        part.stats.miss_latency.Record(miss_nanos);
+                    }
+                    frame.read_in_progress.store(false, std::memory_order_release);
+                }
+            }
+            part.io_done.notify_all();
+            begin = end;
+        }
+
+        // 4. 遇到读进行中的页或无帧可用时逐页等待，这种情况只在与其他线程的读重叠或缓冲池被 pin 满时出现
+        std::vector<bool> waited(page_ids.size(), false);
+        for (size_t i : waits) {
+            bool hit = false;
+            bool page_waited = false;
+            pages[i] = FetchPageImpl(page_ids[i], strategy, &hit, &page_waited);
+            hits[i] = hit;
+            waited[i] = page_waited;
+        }
+        if (strategy != nullptr && strategy->read_ahead_.enabled) {
+            for (size_t i = 0; i < page_ids.size(); i++) {
+                if (pages[i] != nullptr) {
+                    ReadAheadAfter(page_ids[i], *strategy, hits[i], waited[i]);
+                }
+            }
+        }
+        return pages;
+    }
+    std::vector<ReadPageGuard> BufferPool::FetchPagesRead(const std::vector<PageID>& page_ids,
+                                                          BufferAccessStrategy* strategy) {
+        std::vector<Page*> pages = FetchPages(page_ids, strategy);
+        std::vector<ReadPageGuard> guards;
+        guards.reserve(pages.size());
+        for (Page* page : pages) {
+            if (page == nullptr) {
+                guards.emplace_back();
+                continue;
+            }
+            page->latch.lock_shared();
+            guards.emplace_back(this, page);
+        }
+        return guards;
+    }
+    Frame* BufferPool::TryPinLockFree(Partition& part, PageID page_id, AccessType access_type) {
+        frame_id_t fid;
+        if (!part.page_table.Find(page_id, &fid)) {
+            return nullptr;
+        }
+        Frame& frame = GetFrame(part, fid);
+        if (!frame.TryPin()) {
+            return nullptr; //帧正被独占（淘汰/写出/载入中）
+        }
+        // pin 成功后帧不会再被淘汰；但查到的映射可能已过时，需确认帧里仍是这一页且已读完
+        if (frame.page.page_id.load(std::memory_order_acquire) != page_id ||
+            frame.read_in_progress.load(std::memory_order_acquire)) {
+            frame.pin_count.fetch_sub(1, std::memory_order_release);
+            return nullptr;
+        }
+        part.replacer->RecordAccess(fid, access_type);
+        LOG_DEBUG("Fetch page " + std::to_string(page_id) + " from buffer without lock");
+        return &frame;
+    }
+    bool BufferPool::WaitForFrame(Partition& part, size_t part_idx, BufferAccessStrategy* strategy,
+                                  std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point deadline,
+                                  frame_id_t* fid, VictimWrite* victim) {
+        *fid = INVALID_FRAME_ID;
+        int timeout_ms = config_.frame_wait_timeout_ms;
+        if (timeout_ms > 0 && std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        // 先登记再重试：UnpinPage 把 pin_count 减到 0 后才读 frame_waiters（二者均为 seq_cst），
+        // 要么这次重试看到了 unpin 的结果，要么 unpin 方看到等待者，加锁后通知时本线程已在等待
+        part.frame_waiters.fetch_add(1, std::memory_order_seq_cst);
+        *fid = AllocateFrame(part, part_idx, strategy, victim);
+        if (*fid == INVALID_FRAME_ID && !victim->Pending()) {
+            if (timeout_ms < 0) {
+                part.io_done.wait(lock);
+            } else {
+                part.io_done.wait_until(lock, deadline);
+            }
+        }
+        part.frame_waiters.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    frame_id_t BufferPool::AllocateFrame(Partition& part, size_t part_idx, BufferAccessStrategy* strategy,
+                                         VictimWrite* victim) {
+        // 顺序扫描先复用自己的帧环，其次使用空闲帧，最后由置换器选出淘汰页
+        frame_id_t fid = INVALID_FRAME_ID;
+        if (strategy != nullptr) {
+            // 有空闲帧时不为复用环中的脏页写盘
+            fid = TakeRingFrame(part, strategy->rings_[part_idx], part.free_list.empty() ? victim : nullptr);
+        }
+        if (fid == INVALID_FRAME_ID && (victim == nullptr || !victim->Pending())) {
+            if (!part.free_list.empty()) {
+                fid = part.free_list.back();
+                part.free_list.pop_back();
+                // 持有过时页表项的无锁读者可能正短暂地 pin 着空闲帧，等它发现页号不符后释放
+                while (!GetFrame(part, fid).TryClaim()) {
+                    std::this_thread::yield();
+                }
+            } else {
+                fid = EvictFrame(part, victim);
+            }
+        }
+        return fid;
+    }
+    void BufferPool::PrefetchPages(const std::vector<PageID>& page_ids, BufferAccessStrategy* strategy) {
+        AccessType access_type = strategy != nullptr ? AccessType::SEQUENTIAL : AccessType::NORMAL;
+        std::vector<PageIO> reads;
+        std::vector<Frame*> read_frames;
+        // 1. 逐页在分区锁内分配帧并登记到页表，帧标记为读进行中，其他线程访问时会等待
+        for (PageID page_id : page_ids) {
+            size_t part_idx = GetPartitionIndex(page_id);
+            Partition& part = *partitions_[part_idx];
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            frame_id_t fid;
+            if (part.page_table.Find(page_id, &fid)) {
+                continue;
+            }
+            fid = AllocateFrame(part, part_idx, strategy, nullptr);
+            if (fid == INVALID_FRAME_ID) {
+                break; //没有干净的帧可用时放弃剩余的预读，预读不为腾出帧而写盘
+            }
+            Frame& frame = GetFrame(part, fid);
+            frame.page.page_id = page_id;
+            frame.page.pin_count = 0;
+            frame.page.is_dirty = false;
+            frame.is_dirty = false;
+            frame.read_in_progress = true;
+            frame.pin_count.store(0, std::memory_order_release); //结束独占，读完成前访问者会看到 read_in_progress
+            part.reads_in_flight++;
+            PartitionStats::Add(part.stats.prefetched_pages);
+            part.page_table.Insert(page_id, fid);
+            part.replacer->RecordLoad(fid, page_id, access_type);
+            if (strategy != nullptr) {
+                auto& ring = strategy->rings_[part_idx];
+                ring.pages[ring.cursor] = page_id;
+                ring.cursor = (ring.cursor + 1) % ring.pages.size();
+            }
+            reads.push_back({page_id, frame.page.GetData()});
+            read_frames.push_back(&frame);
+        }
+        // 2. 正在迁入本池的文件页先向 peer 取，取到的直接完成；帧处于读进行中，只有本线程会写它
+        if (num_migrating_files_.load(std::memory_order_acquire) > 0) {
+            std::vector<PageIO> from_disk;
+            for (size_t i = 0; i < reads.size(); i++) {
+                PageID page_id = reads[i].page_id;
+                bool dirty = false;
+                if (!IsMigrating(GetFileID(page_id)) || !MigrateFromPeers(page_id, reads[i].data, &dirty)) {
+                    from_disk.push_back(reads[i]);
+                    continue;
+                }
+                if (dirty) {
+                    read_frames[i]->is_dirty.store(true, std::memory_order_relaxed);
+                }
+                PartitionStats::Add(GetPartition(page_id).stats.migrated_pages);
+                CompletePrefetch(page_id, true, ChecksumVerify::NEVER);
+            }
+            reads.swap(from_disk);
+        }
+        // 3. 不持锁整批提交；完成回调会获取分区锁
+        if (!reads.empty()) {
+            LOG_DEBUG("Prefetch " + std::to_string(reads.size()) + " pages from " + std::to_string(reads.front().page_id));
+            ChecksumVerify verify = strategy != nullptr ? strategy->verify_ : config_.verify_checksums;
+            disk_manager_->ReadPagesAsync(reads, [this, verify](PageID page_id, bool ok) {
+                CompletePrefetch(page_id, ok, verify);
+            });
+        }
+    }
+    void BufferPool::CompletePrefetch(PageID page_id, bool ok, ChecksumVerify verify) {
+        Partition& part = GetPartition(page_id);
+        {
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            frame_id_t fid;
+            // 读进行中的帧不会被淘汰，页表项一定存在
+            part.page_table.Find(page_id, &fid);
+            Frame& frame = GetFrame(part, fid);
+            part.reads_in_flight--;
+            ok = ok && VerifyRead(part, page_id, frame.page.GetData(), verify);
+            if (!ok) {
+                // 先改页号再清除读标记，短暂 pin 住该帧的无锁读者会发现页号不符而放弃
+                LOG_ERROR("Prefetch page " + std::to_string(page_id) + " failed");
+                part.replacer->Remove(fid);
+                part.page_table.Erase(page_id);
+                frame.page.page_id = INVALID_PAGE_ID;
+                ReleaseFrame(part, fid); //预读期间可能发生了缩容
+            }
+            frame.read_in_progress.store(false, std::memory_order_release);
+        }
+        part.io_done.notify_all();
+    }
+    bool BufferPool::LoadPage(Partition& part, std::unique_lock<std::mutex>& lock, frame_id_t fid,
+                              PageID page_id, AccessType access_type, ChecksumVerify verify) {
+        Frame& frame = GetFrame(part, fid);
+        frame.read_in_progress = true;
+        frame.pin_count.store(0, std::memory_order_release); //结束独占，读完成前访问者会看到 read_in_progress
+        part.reads_in_flight++;
+        part.page_table.Insert(page_id, fid);
+        part.replacer->RecordLoad(fid, page_id, access_type);
+        lock.unlock();
+
+        bool dirty = false;
+        bool migrated = IsMigrating(GetFileID(page_id)) && MigrateFromPeers(page_id, frame.page.GetData(), &dirty);
+        bool ok = migrated || disk_manager_->ReadPage(page_id, frame.page.GetData());
+
+        lock.lock();
+        part.reads_in_flight--;
+        ok = ok && (migrated || VerifyRead(part, page_id, frame.page.GetData(), verify));
+        if (!ok) {
+            // 先改页号再清除读标记，短暂 pin 住该帧的无锁读者会发现页号不符而放弃
+            LOG_ERROR("Load page " + std::to_string(page_id) + " failed");
+            part.replacer->Remove(fid);
+            part.page_table.Erase(page_id);
+            frame.page.page_id = INVALID_PAGE_ID;
+            ReleaseFrame(part, fid);
+        } else {
+            if (dirty) {
+                frame.is_dirty.store(true, std::memory_order_relaxed);
+            }
+            if (migrated) {
+                PartitionStats::Add(part.stats.migrated_pages);
+            }
+            frame.pin_count.fetch_add(1, std::memory_order_acquire);
+        }
+        frame.read_in_progress.store(false, std::memory_order_release);
+        part.io_done.notify_all();
+        return ok;
+    }
+    bool BufferPool::MigrateFromPeers(PageID page_id, char* dest, bool* dirty) {
+        std::vector<BufferPool*> peers;
+        {
+            std::shared_lock<std::shared_mutex> lock(migration_mutex_);
+            peers = peers_;
+        }
+        for (BufferPool* peer : peers) {
+            if (peer->HandOverPage(page_id, dest, dirty)) {
+                LOG_DEBUG("Migrate page " + std::to_string(page_id) + " from another buffer pool");
+                return true;
+            }
+        }
+        return false;
+    }
+    bool BufferPool::HandOverPage(PageID page_id, char* dest, bool* dirty) {
+        Partition& part = GetPartition(page_id);
+        std::unique_lock<std::mutex> lock = LockPartition(part);
+        frame_id_t fid;
+        while (part.page_table.Find(page_id, &fid)) {
+            Frame& frame = GetFrame(part, fid);
+            if (frame.read_in_progress || frame.write_in_progress) {
+                // 切换前发起的预读或后台写尚未完成，旧副本写盘前不能交出页面
+                part.io_done.wait(lock);
+                continue;
+            }
+            if (!frame.TryClaim()) {
+                // 无锁读者短暂 pin 着该帧（查到过时映射后会马上释放），稍后重试
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+                continue;
+            }
+            memcpy(dest, frame.page.GetData(), PAGE_SIZE);
+            *dirty = frame.is_dirty.exchange(false);
+            part.replacer->Remove(fid);
+            part.page_table.Erase(page_id);
+            frame.page.page_id = INVALID_PAGE_ID;
+            frame.pin_count.store(0, std::memory_order_release);
+            ReleaseFrame(part, fid);
+            return true;
+        }
+        return false;
+    }
+    void BufferPool::AddPeer(BufferPool* peer) {
+        std::unique_lock<std::shared_mutex> lock(migration_mutex_);
+        if (peer != this && std::find(peers_.begin(), peers_.end(), peer) == peers_.end()) {
+            peers_.push_back(peer);
+        }
+    }
+    bool BufferPool::AdoptFile(FileID file_id, BufferPool* from) {
+        if (from == this) {
+            return true;
+        }
+        std::vector<BufferPool*> peers;
+        {
+            std::unique_lock<std::shared_mutex> lock(migration_mutex_);
+            if (std::find(peers_.begin(), peers_.end(), from) == peers_.end()) {
+                LOG_ERROR("AdoptFile failed: the source buffer pool is not a peer");
+                return false;
+            }
+            if (migrating_files_.insert(file_id).second) {
+                num_migrating_files_.fetch_add(1, std::memory_order_release);
+            }
+            peers = peers_;
+        }
+        for (BufferPool* peer : peers) {
+            peer->StopMigrating(file_id);
+        }
+        return true;
+    }
+    bool BufferPool::IsMigrating(FileID file_id) {
+        if (num_migrating_files_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        std::shared_lock<std::shared_mutex> lock(migration_mutex_);
+        return migrating_files_.count(file_id) > 0;
+    }
+    void BufferPool::StopMigrating(FileID file_id) {
+        std::unique_lock<std::shared_mutex> lock(migration_mutex_);
+        if (migrating_files_.erase(file_id) > 0) {
+            num_migrating_files_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    void BufferPool::ReadAheadAfter(PageID page_id, BufferAccessStrategy& strategy, bool hit, bool waited) {
+        auto& ra = strategy.read_ahead_;
+        int32_t page_no = GetPageNo(page_id);
+        if (GetFileID(page_id) != ra.file_id) {
+            return;
+        }
+        if (ra.last_page_no == -1 && !(disk_manager_->IsAsyncIO() && disk_manager_->IsDirectIO(ra.file_id))) {
+            // 同步引擎下预读无法与消费重叠；缓冲 I/O 时内核已在页缓存层做了顺序预读，重复预读只增加开销
+            ra.enabled = false;
+            return;
+        }
+        bool sequential = page_no == ra.last_page_no + 1;
+        ra.last_page_no = page_no;
+        if (!sequential) {
+            // 跳跃访问：重置窗口，等待新的连续访问
+            ra.window = ra.initial_window;
+            ra.next_page_no = page_no + 1;
+            return;
+        }
+        if (waited) {
+            // 消费者追上了在途的读，窗口不足以掩盖 I/O 延迟
+            ra.window = std::min(ra.window * 2, ra.max_window);
+        } else if (!hit && page_no < ra.next_page_no) {
+            // 预读过的页在被消费前就被换出，消费太慢，缩小窗口
+            ra.window = std::max(ra.window / 2, 1);
+        }
+        ra.next_page_no = std::max(ra.next_page_no, page_no + 1);
+        // 已预读的页不足半个窗口时才发起下一批，使预读与消费重叠
+        if (ra.next_page_no - page_no > ra.window / 2) {
             return;
         }
-        if (it->second.pin_count > 0) {
-            it->second.pin_count--;
+        int32_t end = std::min(page_no + 1 + ra.window, ra.end_page_no);
+        std::vector<PageID> page_ids;
+        for (int32_t p = ra.next_page_no; p < end; p++) {
+            page_ids.push_back(MakePageID(ra.file_id, p));
+        }
+        ra.next_page_no = std::max(ra.next_page_no, end);
+        if (!page_ids.empty()) {
+            PrefetchPages(page_ids, &strategy);
+        }
+    }
+    void BufferPool::UnpinPage(PageID page_id, bool is_dirty)  {
+        Partition& part = GetPartition(page_id);
+        frame_id_t fid;
+        // 调用方持有 pin，帧不会被淘汰；无锁查找偶尔因并发删除而漏查时再加锁查一次
+        if (!part.page_table.Find(page_id, &fid)) {
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            if (!part.page_table.Find(page_id, &fid)) {
+                LOG_ERROR("UnpinPage: Page " + std::to_string(page_id) + " not found");
+                return;
+            }
+        }
+        Frame& frame = GetFrame(part, fid);
+        // 先置脏再释放 pin，独占该帧的淘汰线程一定能看到脏标记
+        if (is_dirty) {
+            frame.is_dirty.store(true, std::memory_order_relaxed);
+        }
+        int pins = frame.pin_count.load(std::memory_order_relaxed);
+        while (pins > 0 && !frame.pin_count.compare_exchange_weak(pins, pins - 1, std::memory_order_seq_cst)) {
+        }
+        if (pins <= 0) {
+            LOG_ERROR("UnpinPage: Page " + std::to_string(page_id) + " is not pinned");
+            return;
         }
-        if(is_dirty) {
-            it->second.is_dirty = true;
-            it->second.page.is_dirty = true;
+        // 最后一个 pin 释放时唤醒等待可用帧的线程；加一次锁保证通知不会落在对方重试分配与开始等待之间
+        if (pins == 1 && part.frame_waiters.load(std::memory_order_seq_cst) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(part.mutex);
+            }
+            part.io_done.notify_all();
         }
-        LOG_DEBUG("Unpin page " + std::to_string(page_id) + ", pin_count: " + std::to_string(it->second.pin_count));
+        LOG_DEBUG("Unpin page " + std::to_string(page_id) + ", pin_count: " + std::to_string(pins - 1));
     }
     void BufferPool::FlushPage(PageID page_id) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = frame_map_.find(page_id);
-        if(it == frame_map_.end()) {
+        Partition& part = GetPartition(page_id);
+        std::unique_lock<std::mutex> lock = LockPartition(part);
+        frame_id_t fid;
+        if(!part.page_table.Find(page_id, &fid)) {
             LOG_ERROR("FlushPage failed: page " + std::to_string(page_id) + " not found");
             return ;
         }
-        if(it->second.is_dirty) {
+        Frame& frame = GetFrame(part, fid);
+        char copy[PAGE_SIZE];
+        if (frame.read_in_progress || CopyForWrite(part, lock, frame, copy, true) != CopyResult::COPIED) {
+            LOG_DEBUG("Page " + std::to_string(page_id) + " is clean, no need to flush");
+            return;
+        }
+        lock.unlock();
+        bool ok = disk_manager_->WritePage(page_id, copy);
+        lock.lock();
+        FinishWrite(part, frame, page_id, ok);
+        lock.unlock();
+        part.io_done.notify_all();
+        if (ok) {
             LOG_INFO("Flush dirty page " + std::to_string(page_id) + " to disk");
-            it->second.is_dirty = false; 
-            it->second.page.is_dirty = false;
+        }
+    }
+    BufferPool::CopyResult BufferPool::CopyForWrite(Partition& part, std::unique_lock<std::mutex>& lock,
+                                                    Frame& frame, char* dest, bool wait_latch) {
+        PageID page_id = frame.page.page_id;
+        // pin 住后帧不会被淘汰；加闩须在分区锁之外，持有写闩的线程可能正在等这把锁
+        frame.pin_count.fetch_add(1, std::memory_order_acquire); //持锁时帧不会处于独占状态
+        lock.unlock();
+        if (!frame.page.latch.try_lock_shared()) {
+            if (!wait_latch) {
+                UnpinPage(page_id, false);
+                lock.lock();
+                return CopyResult::LATCH_BUSY;
+            }
+            frame.page.latch.lock_shared();
+        }
+        lock.lock();
+        // 同一页的两次写须按拷贝的先后落盘，等他人在途的写完成
+        part.io_done.wait(lock, [&frame]() { return !frame.write_in_progress; });
+        // 先清除脏标记再拷贝：拷贝之后的修改会在 unpin 时重新置脏，留给下一次刷盘
+        bool dirty = frame.is_dirty.exchange(false);
+        if (dirty) {
+            frame.write_in_progress = true;
+        }
+        lock.unlock();
+        if (dirty) {
+            memcpy(dest, frame.page.GetData(), PAGE_SIZE);
+            StampChecksum(page_id, dest);
+        }
+        frame.page.latch.unlock_shared();
+        UnpinPage(page_id, false);
+        lock.lock();
+        return dirty ? CopyResult::COPIED : CopyResult::CLEAN;
+    }
+    void BufferPool::FinishWrite(Partition& part, Frame& frame, PageID page_id, bool ok) {
+        frame.write_in_progress = false;
+        if (!ok) {
+            LOG_ERROR("Flush page " + std::to_string(page_id) + " failed, keep it dirty");
+            frame.is_dirty = true;
+            return;
+        }
+        PartitionStats::Add(part.stats.dirty_flushes);
+        RememberWrite(page_id);
+    }
+    bool BufferPool::FlushAll(bool sync_files) {
+        std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+        struct DirtyPage {
+            PageID page_id;
+            size_t part_idx;
+            frame_id_t fid;
+        };
+        // 1. 每个分区加一次锁收集脏页；正在被后台写线程或腾空写出的页也收集，同步文件前须等它们写完
+        std::vector<DirtyPage> dirty;
+        for (size_t part_idx = 0; part_idx < partitions_.size(); part_idx++) {
+            Partition& part = *partitions_[part_idx];
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            frame_id_t part_frames = static_cast<frame_id_t>(part.frames.size());
+            for (frame_id_t local = 0; local < part_frames; local++) {
+                Frame& frame = GetFrame(part, local);
+                if (frame.page.page_id != INVALID_PAGE_ID && !frame.read_in_progress &&
+                    (frame.is_dirty || frame.write_in_progress)) {
+                    dirty.push_back({frame.page.page_id, part_idx, local});
+                }
+            }
+        }
+        // 按 PageID 排序：同一文件的页相邻且页号递增，连续页的写可以合并
+        std::sort(dirty.begin(), dirty.end(),
+                  [](const DirtyPage& a, const DirtyPage& b) { return a.page_id < b.page_id; });
+
+        // 2. 逐页在页的读闩下拷贝出副本，攒满一批后在锁外整批写盘
+        std::vector<char> buffer(std::min(dirty.size(), static_cast<size_t>(FLUSH_BATCH_PAGES)) * PAGE_SIZE);
+        std::vector<DirtyPage> batch;
+        std::vector<PageIO> writes;
+        bool all_ok = true;
+        size_t written = 0;
+        auto write_batch = [&]() {
+            if (batch.empty()) {
+                return;
+            }
+            disk_manager_->WritePages(writes);
+            for (size_t i = 0; i < batch.size(); i++) {
+                Partition& part = *partitions_[batch[i].part_idx];
+                {
+                    std::unique_lock<std::mutex> lock = LockPartition(part);
+                    FinishWrite(part, GetFrame(part, batch[i].fid), batch[i].page_id, writes[i].ok);
+                }
+                part.io_done.notify_all();
+                if (writes[i].ok) {
+                    written++;
+                } else {
+                    all_ok = false;
+                }
+            }
+            batch.clear();
+            writes.clear();
+        };
+        for (const DirtyPage& page : dirty) {
+            if (batch.size() == FLUSH_BATCH_PAGES) {
+                write_batch();
+            }
+            Partition& part = *partitions_[page.part_idx];
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            Frame& frame = GetFrame(part, page.fid);
+            // 等待在途的写完成；等待期间或收集之后该帧可能已被淘汰、换了页或已被写回
+            for (bool wait_latch = false;; wait_latch = true) {
+                part.io_done.wait(lock, [&frame]() { return !frame.write_in_progress; });
+                if (frame.page.page_id != page.page_id || frame.read_in_progress || !frame.is_dirty) {
+                    break;
+                }
+                char* copy = buffer.data() + batch.size() * PAGE_SIZE;
+                CopyResult result = CopyForWrite(part, lock, frame, copy, wait_latch);
+                if (result == CopyResult::COPIED) {
+                    batch.push_back(page);
+                    writes.push_back({page.page_id, copy});
+                }
+                if (result != CopyResult::LATCH_BUSY) {
+                    break;
+                }
+                // 页正被写闩住：先写出本批，不在持有这些页的写标记时等待其他线程
+                lock.unlock();
+                write_batch();
+                lock.lock();
+            }
+        }
+        write_batch();
+
+        // 3. 每个涉及的文件只同步一次（dirty 已排序，同一文件的页相邻）
+        if (sync_files) {
+            FileID last_file = INVALID_FILE_ID;
+            for (const auto& page : dirty) {
+                FileID file_id = GetFileID(page.page_id);
+                if (file_id != last_file) {
+                    disk_manager_->SyncFile(file_id);
+                    last_file = file_id;
+                }
+            }
+        }
+        LOG_INFO("FlushAll wrote " + std::to_string(written) + " dirty pages");
+        return all_ok;
+    }
+    void BufferPool::RememberWrite(PageID page_id) {
+        recent_writes_[static_cast<uint32_t>(page_id) % RECENT_WRITE_SLOTS].store(page_id, std::memory_order_relaxed);
+    }
+    bool BufferPool::VerifyRead(Partition& part, PageID page_id, const char* data, ChecksumVerify verify) {
+        if (verify == ChecksumVerify::NEVER) {
+            return true;
+        }
+        if (verify == ChecksumVerify::SKIP_SELF_WRITTEN &&
+            recent_writes_[static_cast<uint32_t>(page_id) % RECENT_WRITE_SLOTS].load(std::memory_order_relaxed) ==
+                page_id) {
+            PartitionStats::Add(part.stats.checksum_skips);
+            return true;
+        }
+        if (!VerifyPageChecksum(data, GetPageNo(page_id))) {
+            PartitionStats::Add(part.stats.checksum_failures);
+            LOG_ERROR("Checksum mismatch on page " + std::to_string(page_id) + ", page is corrupted");
+            return false;
+        }
+        return true;
+    }
+    frame_id_t BufferPool::EvictFrame(Partition& part, VictimWrite* victim) {
+        // 由置换器挑选 pin_count 为 0 的干净帧并独占它；脏页不在持有分区锁时写盘，交给调用方在锁外写出
+        auto is_evictable = [this, &part, victim](frame_id_t fid) {
+            Frame& frame = GetFrame(part, fid);
+            if (victim != nullptr && victim->Pending()) {
+                return false; //已选中脏页，先写出它，不再淘汰别的页
+            }
+            if (frame.write_in_progress || frame.read_in_progress || !frame.TryClaim()) {
+                return false;
+            }
+            if (frame.is_dirty) {
+                if (victim != nullptr && !victim->Pending()) {
+                    TakeVictim(part, fid, victim);
+                }
+                frame.pin_count.store(0, std::memory_order_release);
+                return false;
+            }
+            return true;
+        };
+        frame_id_t fid;
+        while (true) {
+            if (!part.replacer->Evict(is_evictable, &fid)) {
+                if (victim != nullptr && victim->Pending()) {
+                    return INVALID_FRAME_ID;
+                }
+                PartitionStats::Add(part.stats.evict_failures);
+                LOG_DEBUG("Evict failed: all pages are pinned"); //FetchPage 会等待可用帧，超时后才报错
+                return INVALID_FRAME_ID;
+            }
+            // 移除页表项
+            Frame& frame = GetFrame(part, fid);
+            PageID evict_id = frame.page.page_id;
+            part.page_table.Erase(evict_id);
+            frame.page.page_id = INVALID_PAGE_ID;
+            PartitionStats::Add(part.stats.evictions);
+            LOG_DEBUG("Evict page " + std::to_string(evict_id) + " by " + part.replacer->Name());
+            if (fid < part.num_active) {
+                return fid;
+            }
+            // 淘汰到的是待停用的帧：顺带停用它，继续找下一个
+            frame.retired = true;
+            part.num_retiring--;
+            frame.pin_count.store(0, std::memory_order_release);
+        }
+    }
+    frame_id_t BufferPool::TakeRingFrame(Partition& part, BufferAccessStrategy::Ring& ring, VictimWrite* victim) {
+        // 环尚未填满，或环中的页已被换出/正在被他人使用时，退回到常规分配路径
+        PageID old_page = ring.pages[ring.cursor];
+        frame_id_t fid;
+        if (old_page == INVALID_PAGE_ID || !part.page_table.Find(old_page, &fid) || fid >= part.num_active) {
+            return INVALID_FRAME_ID;
+        }
+        Frame& frame = GetFrame(part, fid);
+        if (frame.write_in_progress || frame.read_in_progress || !frame.TryClaim()) {
+            return INVALID_FRAME_ID;
+        }
+        if (frame.is_dirty) {
+            if (victim != nullptr && !victim->Pending()) {
+                TakeVictim(part, fid, victim);
+            }
+            frame.pin_count.store(0, std::memory_order_release);
+            return INVALID_FRAME_ID;
+        }
+        part.replacer->Remove(fid);
+        part.page_table.Erase(old_page);
+        frame.page.page_id = INVALID_PAGE_ID;
+        PartitionStats::Add(part.stats.evictions);
+        LOG_DEBUG("Reuse ring frame of page " + std::to_string(old_page));
+        return fid;
+    }
+    void BufferPool::TakeVictim(Partition& part, frame_id_t fid, VictimWrite* victim) {
+        // 独占期间没有人 pin 住（因而也没有人持有闩）修改该页，拷贝出的副本是完整的
+        Frame& frame = GetFrame(part, fid);
+        victim->page_id = frame.page.page_id;
+        victim->fid = fid;
+        victim->data.resize(PAGE_SIZE);
+        memcpy(victim->data.data(), frame.page.GetData(), PAGE_SIZE);
+        StampChecksum(victim->page_id, victim->data.data());
+        frame.write_in_progress = true;
+        frame.is_dirty = false;
+    }
+    void BufferPool::WriteVictim(Partition& part, std::unique_lock<std::mutex>& lock, VictimWrite* victim) {
+        lock.unlock();
+        bool ok = disk_manager_->WritePage(victim->page_id, victim->data.data());
+        lock.lock();
+        Frame& frame = GetFrame(part, victim->fid);
+        frame.write_in_progress = false;
+        if (!ok) {
+            LOG_ERROR("Flush page " + std::to_string(victim->page_id) + " failed, keep it dirty");
+            frame.is_dirty = true;
         } else {
-            LOG_DEBUG("Page " + std::to_string(page_id) + " is clean, no need to flush");
+            PartitionStats::Add(part.stats.dirty_flushes);
+            RememberWrite(victim->page_id);
+            LOG_DEBUG("Flush dirty victim page " + std::to_string(victim->page_id) + " to disk");
         }
+        victim->page_id = INVALID_PAGE_ID;
+        part.io_done.notify_all();
     }
-    void BufferPool::UpdateLRU(PageID page_id) {
-        auto it = frame_map_.find(page_id);
-        if (it != frame_map_.end()) {
-            // 移除旧位置，插入到头部
-            lru_list_.erase(it->second.lru_iter);
-            lru_list_.push_front(page_id);
-            it->second.lru_iter = lru_list_.begin();
+    void BufferPool::BackgroundWriterLoop() {
+        size_t budget = std::max<size_t>(1, static_cast<size_t>(config_.bg_writer_max_pages_per_sec) *
+                                                config_.bg_writer_interval_ms / 1000);
+        std::unique_lock<std::mutex> lock(bg_writer_mutex_);
+        while (!bg_writer_stop_) {
+            bg_writer_cv_.wait_for(lock, std::chrono::milliseconds(config_.bg_writer_interval_ms),
+                                   [this]() { return bg_writer_stop_.load(); });
+            if (bg_writer_stop_) {
+                break;
+            }
+            lock.unlock();
+            size_t written = BackgroundWriteRound(budget);
+            if (written > 0) {
+                LOG_DEBUG("Background writer flushed " + std::to_string(written) + " pages");
+            }
+            lock.lock();
         }
     }
+    size_t BufferPool::BackgroundWriteRound(size_t budget) {
+        struct PendingWrite {
+            PageID page_id;
+            size_t part_idx;
+            frame_id_t fid;
+            size_t slot; //在 buffer 中的位置
+        };
+        std::vector<PendingWrite> pending;
+        std::vector<char> buffer(budget * PAGE_SIZE);
+        std::vector<frame_id_t> candidates;
 
-    void BufferPool::EvictLRU() {
-        // 找到LRU链表尾部（最久未使用）且pin_count为0的页
-        auto it = lru_list_.rbegin();
-        while (it != lru_list_.rend()) {
-            PageID evict_id = *it;
-            auto frame_it = frame_map_.find(evict_id);
-            if (frame_it->second.pin_count == 0) {
-                // 若为脏页，先刷盘
-                if (frame_it->second.is_dirty) {
-                    FlushPage(evict_id);
+        // 1. 逐个分区在锁内收集冷端的脏页，把内容拷贝出来并标记为写出中
+        size_t num_partitions = partitions_.size();
+        for (size_t i = 0; i < num_partitions && pending.size() < budget; i++) {
+            size_t part_idx = (bg_writer_next_partition_ + i) % num_partitions;
+            Partition& part = *partitions_[part_idx];
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            candidates.clear();
+            part.replacer->GetEvictionCandidates(config_.bg_writer_scan_depth, &candidates);
+            for (frame_id_t fid : candidates) {
+                if (pending.size() >= budget) {
+                    break;
                 }
-                // 移除帧和LRU节点
-                frame_map_.erase(evict_id);
-                lru_list_.erase(std::next(it).base());
-                LOG_DEBUG("Evict LRU page " + std::to_string(evict_id));
-                return;
+                Frame& frame = GetFrame(part, fid);
+                if (!frame.is_dirty || frame.write_in_progress || frame.read_in_progress || !frame.TryClaim()) {
+                    continue;
+                }
+                // 拷贝期间独占该帧，不会有人 pin 住并修改它
+                size_t slot = pending.size();
+                memcpy(buffer.data() + slot * PAGE_SIZE, frame.page.GetData(), PAGE_SIZE);
+                StampChecksum(frame.page.page_id, buffer.data() + slot * PAGE_SIZE);
+                frame.write_in_progress = true;
+                frame.is_dirty = false;
+                frame.pin_count.store(0, std::memory_order_release);
+                pending.push_back({frame.page.page_id, part_idx, fid, slot});
+            }
+        }
+        bg_writer_next_partition_ = (bg_writer_next_partition_ + 1) % num_partitions;
+
+        // 2. 按 PageID 排序后在锁外整批写盘，同一文件的相邻页尽量顺序写
+        std::sort(pending.begin(), pending.end(),
+                  [](const PendingWrite& a, const PendingWrite& b) { return a.page_id < b.page_id; });
+        std::vector<PageIO> writes;
+        writes.reserve(pending.size());
+        for (const auto& write : pending) {
+            writes.push_back({write.page_id, buffer.data() + write.slot * PAGE_SIZE});
+        }
+        disk_manager_->WritePages(writes);
+        for (size_t i = 0; i < pending.size(); i++) {
+            const PendingWrite& write = pending[i];
+            Partition& part = *partitions_[write.part_idx];
+            {
+                std::unique_lock<std::mutex> lock = LockPartition(part);
+                Frame& frame = GetFrame(part, write.fid);
+                frame.write_in_progress = false;
+                if (!writes[i].ok) {
+                    LOG_ERROR("Background write of page " + std::to_string(write.page_id) + " failed, keep it dirty");
+                    frame.is_dirty = true;
+                } else {
+                    PartitionStats::Add(part.stats.bg_writer_flushes);
+                    RememberWrite(write.page_id);
+                }
+            }
+            part.io_done.notify_all();
+        }
+        return pending.size();
+    }
+    void BufferPool::SetActiveFrames(Partition& part, frame_id_t num_active) {
+        frame_id_t old_active = part.num_active;
+        part.num_active = num_active;
+        if (num_active > old_active) {
+            // 已停用的帧放回空闲链表；尚未腾空的帧直接恢复可用，其中的页面继续留在缓冲池中
+            for (frame_id_t local = old_active; local < num_active; local++) {
+                Frame& frame = GetFrame(part, local);
+                if (frame.retired) {
+                    frame.retired = false;
+                    part.free_list.push_back(local);
+                } else {
+                    part.num_retiring--;
+                }
+            }
+            part.io_done.notify_all(); //唤醒等待可用帧的线程
+        } else if (num_active < old_active) {
+            // 空闲帧立即停用，持有页面的帧留给腾空线程
+            auto keep_end = std::remove_if(part.free_list.begin(), part.free_list.end(), [&](frame_id_t local) {
+                if (local < num_active) {
+                    return false;
+                }
+                GetFrame(part, local).retired = true;
+                return true;
+            });
+            part.free_list.erase(keep_end, part.free_list.end());
+            for (frame_id_t local = num_active; local < old_active; local++) {
+                if (!GetFrame(part, local).retired) {
+                    part.num_retiring++;
+                }
+            }
+        }
+        part.replacer->SetCapacity(num_active);
+    }
+    void BufferPool::ReleaseFrame(Partition& part, frame_id_t local_id) {
+        if (local_id < part.num_active) {
+            part.free_list.push_back(local_id);
+            if (part.frame_waiters.load(std::memory_order_relaxed) > 0) {
+                part.io_done.notify_all(); //调用方持有分区锁，等待者要等它释放后才会醒来重试
+            }
+        } else {
+            GetFrame(part, local_id).retired = true;
+            part.num_retiring--;
+        }
+    }
+    void BufferPool::RegisterFrames(int num_frames) {
+        if (num_frames == registered_frames_) {
+            return;
+        }
+        // 停用帧的内存即将归还，不能继续被 I/O 引擎持有（io_uring 固定缓冲区会长期 pin 住这些页）
+        disk_manager_->UnregisterBufferRegion(page_arena_->Data(), page_arena_->Size());
+        disk_manager_->RegisterBufferRegion(page_arena_->Data(), static_cast<size_t>(num_frames) * PAGE_SIZE);
+        registered_frames_ = num_frames;
+    }
+    bool BufferPool::Resize(int new_frames) {
+        if (new_frames < GetNumPartitions() || new_frames > capacity_frames_) {
+            LOG_ERROR("Resize failed: " + std::to_string(new_frames) + " frames out of range [" +
+                      std::to_string(GetNumPartitions()) + ", " + std::to_string(capacity_frames_) + "]");
+            return false;
+        }
+        std::lock_guard<std::mutex> resize_lock(resize_mutex_);
+        int old_frames = max_frames.exchange(new_frames);
+        if (new_frames > registered_frames_) {
+            RegisterFrames(new_frames); //启用之前注册，新帧一开始就能用固定缓冲区
+        }
+        size_t num_partitions = partitions_.size();
+        size_t retiring = 0;
+        for (size_t i = 0; i < num_partitions; i++) {
+            Partition& part = *partitions_[i];
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            SetActiveFrames(part, static_cast<frame_id_t>((new_frames - i + num_partitions - 1) / num_partitions));
+            retiring += part.num_retiring;
+        }
+        resize_generation_++;
+        LOG_INFO("Resize buffer pool from " + std::to_string(old_frames) + " to " + std::to_string(new_frames) +
+                 " frames, " + std::to_string(retiring) + " frames to drain");
+        // 即使没有待腾空的帧也交给腾空线程收尾（缩小注册区域、归还内存）
+        if (new_frames < registered_frames_ || retiring > 0) {
+            draining_ = true;
+            if (!resize_thread_.joinable()) {
+                resize_thread_ = std::thread(&BufferPool::ResizeDrainLoop, this);
+            }
+            resize_cv_.notify_all();
+        }
+        return true;
+    }
+    void BufferPool::WaitForResize() {
+        std::unique_lock<std::mutex> lock(resize_mutex_);
+        resize_cv_.wait(lock, [this]() { return !draining_ || resize_stop_; });
+    }
+    void BufferPool::ResizeDrainLoop() {
+        size_t budget = std::max(1, config_.resize_drain_batch);
+        std::unique_lock<std::mutex> lock(resize_mutex_);
+        while (true) {
+            resize_cv_.wait(lock, [this]() { return resize_stop_ || draining_; });
+            if (resize_stop_) {
+                break;
+            }
+            uint64_t generation = resize_generation_;
+            lock.unlock();
+            size_t remaining = DrainRound(budget);
+            lock.lock();
+            if (resize_generation_ != generation) {
+                continue; //期间又发生了 Resize，本轮的结论作废
+            }
+            if (remaining > 0) {
+                resize_cv_.wait_for(lock, std::chrono::milliseconds(config_.resize_drain_interval_ms),
+                                    [this]() { return resize_stop_; });
+                continue;
+            }
+            // 目标之外的帧已全部停用，它们正好是页内存区的尾部
+            int target = max_frames.load(std::memory_order_relaxed);
+            RegisterFrames(target);
+            page_arena_->Discard(static_cast<size_t>(target) * PAGE_SIZE,
+                                 static_cast<size_t>(capacity_frames_ - target) * PAGE_SIZE);
+            draining_ = false;
+            LOG_INFO("Buffer pool resize to " + std::to_string(target) + " frames completed");
+            resize_cv_.notify_all();
+        }
+    }
+    size_t BufferPool::DrainRound(size_t budget) {
+        struct PendingWrite {
+            PageID page_id;
+            size_t part_idx;
+            frame_id_t fid;
+        };
+        std::vector<PendingWrite> pending;
+        std::vector<char> buffer;
+        size_t handled = 0;
+        size_t remaining = 0;
+
+        // 1. 逐个分区在锁内停用干净的未 pin 帧，脏页拷贝出来留到锁外写回；每个分区只持锁处理一小批
+        for (size_t part_idx = 0; part_idx < partitions_.size(); part_idx++) {
+            Partition& part = *partitions_[part_idx];
+            std::unique_lock<std::mutex> lock = LockPartition(part);
+            frame_id_t part_frames = static_cast<frame_id_t>(part.frames.size());
+            for (frame_id_t local = part.num_active; local < part_frames && part.num_retiring > 0 && handled < budget;
+                 local++) {
+                Frame& frame = GetFrame(part, local);
+                if (frame.retired || frame.write_in_progress || frame.read_in_progress || !frame.TryClaim()) {
+                    continue; //被 pin 住或有 I/O 在途的帧等下一轮
+                }
+                handled++;
+                if (frame.is_dirty) {
+                    buffer.resize((pending.size() + 1) * PAGE_SIZE);
+                    memcpy(buffer.data() + pending.size() * PAGE_SIZE, frame.page.GetData(), PAGE_SIZE);
+                    StampChecksum(frame.page.page_id, buffer.data() + pending.size() * PAGE_SIZE);
+                    frame.write_in_progress = true;
+                    frame.is_dirty = false;
+                    frame.pin_count.store(0, std::memory_order_release);
+                    pending.push_back({frame.page.page_id, part_idx, local});
+                    continue;
+                }
+                part.replacer->Remove(local);
+                part.page_table.Erase(frame.page.page_id);
+                frame.page.page_id = INVALID_PAGE_ID;
+                frame.retired = true;
+                part.num_retiring--;
+                frame.pin_count.store(0, std::memory_order_release);
+                PartitionStats::Add(part.stats.evictions);
+            }
+            remaining += part.num_retiring;
+        }
+
+        // 2. 在锁外整批写回脏页；写完后帧变为干净的，下一轮停用
+        if (!pending.empty()) {
+            std::vector<PageIO> writes;
+            writes.reserve(pending.size());
+            for (size_t i = 0; i < pending.size(); i++) {
+                writes.push_back({pending[i].page_id, buffer.data() + i * PAGE_SIZE});
+            }
+            disk_manager_->WritePages(writes);
+            for (size_t i = 0; i < pending.size(); i++) {
+                Partition& part = *partitions_[pending[i].part_idx];
+                {
+                    std::unique_lock<std::mutex> lock = LockPartition(part);
+                    Frame& frame = GetFrame(part, pending[i].fid);
+                    frame.write_in_progress = false;
+                    if (!writes[i].ok) {
+                        LOG_ERROR("Drain write of page " + std::to_string(pending[i].page_id) + " failed, keep it dirty");
+                        frame.is_dirty = true;
+                    } else {
+                        PartitionStats::Add(part.stats.dirty_flushes);
+                        RememberWrite(pending[i].page_id);
+                    }
+                }
+                part.io_done.notify_all();
             }
-            it++;
         }
-        LOG_ERROR("Evict failed: all pages are pinned");
+        return remaining;
     }
 }
\ No newline at end of file
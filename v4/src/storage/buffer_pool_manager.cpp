@@ -0,0 +1,55 @@
+#include "lightdb/buffer_pool_manager.h"
+namespace lightdb {
+    BufferPoolManager::BufferPoolManager(DiskManager* disk_manager) : disk_manager_(disk_manager) {}
+
+    BufferPool* BufferPoolManager::CreatePool(const std::string& name, int frames, const BufferPoolConfig& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pools_.count(name) > 0) {
+            LOG_ERROR("CreatePool failed: buffer pool " + name + " already exists");
+            return nullptr;
+        }
+        auto pool = std::make_unique<BufferPool>(frames, disk_manager_, config);
+        // 共用 DiskManager 的池两两互为 peer，文件改换所在的池时页面才能在它们之间迁移
+        for (auto& entry : pools_) {
+            entry.second->AddPeer(pool.get());
+            pool->AddPeer(entry.second.get());
+        }
+        BufferPool* result = pool.get();
+        pools_[name] = std::move(pool);
+        LOG_INFO("Create buffer pool " + name + " with " + std::to_string(frames) + " frames");
+        return result;
+    }
+
+    BufferPool* BufferPoolManager::GetPool(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pools_.find(name);
+        return it != pools_.end() ? it->second.get() : nullptr;
+    }
+
+    std::string BufferPoolManager::GetPoolName(const BufferPool* pool) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : pools_) {
+            if (entry.second.get() == pool) {
+                return entry.first;
+            }
+        }
+        return "";
+    }
+
+    std::vector<std::pair<std::string, BufferPool*>> BufferPoolManager::GetPools() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<std::string, BufferPool*>> pools;
+        for (const auto& entry : pools_) {
+            pools.emplace_back(entry.first, entry.second.get());
+        }
+        return pools;
+    }
+
+    bool BufferPoolManager::FlushAll(bool sync_files) {
+        bool all_ok = true;
+        for (const auto& entry : GetPools()) {
+            all_ok = entry.second->FlushAll(sync_files) && all_ok;
+        }
+        return all_ok;
+    }
+}
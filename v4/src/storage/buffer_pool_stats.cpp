@@ -0,0 +1,112 @@
+#include "lightdb/buffer_pool_stats.h"
+namespace lightdb {
+    void LatencyHistogram::Record(uint64_t nanos) {
+        uint64_t micros = nanos / 1000;
+        int bucket = 0;
+        while (micros > 0 && bucket < NUM_BUCKETS - 1) {
+            micros >>= 1;
+            bucket++;
+        }
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void LatencyHistogram::Reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::array<uint64_t, LatencyHistogram::NUM_BUCKETS> LatencyHistogram::Snapshot() const {
+        std::array<uint64_t, NUM_BUCKETS> counts{};
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        return counts;
+    }
+
+    uint64_t LatencyHistogram::BucketUpperMicros(int bucket) {
+        if (bucket >= NUM_BUCKETS - 1) {
+            return UINT64_MAX;
+        }
+        return uint64_t(1) << bucket;
+    }
+
+    uint64_t BufferPoolStats::MissLatencyPercentileMicros(double q) const {
+        uint64_t total = 0;
+        for (uint64_t count : miss_latency) {
+            total += count;
+        }
+        if (total == 0) {
+            return 0;
+        }
+        // 第一个累计数达到 q * total 的桶
+        uint64_t target = static_cast<uint64_t>(q * total);
+        target = target == 0 ? 1 : target;
+        uint64_t seen = 0;
+        for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+            seen += miss_latency[i];
+            if (seen >= target) {
+                return LatencyHistogram::BucketUpperMicros(i);
+            }
+        }
+        return UINT64_MAX;
+    }
+
+    BufferPoolStats& BufferPoolStats::operator+=(const BufferPoolStats& other) {
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+        evict_failures += other.evict_failures;
+        frame_waits += other.frame_waits;
+        frame_wait_timeouts += other.frame_wait_timeouts;
+        frame_wait_nanos += other.frame_wait_nanos;
+        dirty_flushes += other.dirty_flushes;
+        bg_writer_flushes += other.bg_writer_flushes;
+        prefetched_pages += other.prefetched_pages;
+        checksum_failures += other.checksum_failures;
+        checksum_skips += other.checksum_skips;
+        migrated_pages += other.migrated_pages;
+        lock_acquisitions += other.lock_acquisitions;
+        lock_contended += other.lock_contended;
+        lock_wait_nanos += other.lock_wait_nanos;
+        miss_nanos += other.miss_nanos;
+        for (int i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+            miss_latency[i] += other.miss_latency[i];
+        }
+        return *this;
+    }
+
+    BufferPoolStats PartitionStats::Snapshot() const {
+        // 各计数器分别读取，快照不是一个原子的整体，但每个值本身都是准确的
+        BufferPoolStats stats;
+        stats.hits = hits.load(std::memory_order_relaxed);
+        stats.misses = misses.load(std::memory_order_relaxed);
+        stats.evictions = evictions.load(std::memory_order_relaxed);
+        stats.evict_failures = evict_failures.load(std::memory_order_relaxed);
+        stats.frame_waits = frame_waits.load(std::memory_order_relaxed);
+        stats.frame_wait_timeouts = frame_wait_timeouts.load(std::memory_order_relaxed);
+        stats.frame_wait_nanos = frame_wait_nanos.load(std::memory_order_relaxed);
+        stats.dirty_flushes = dirty_flushes.load(std::memory_order_relaxed);
+        stats.bg_writer_flushes = bg_writer_flushes.load(std::memory_order_relaxed);
+        stats.prefetched_pages = prefetched_pages.load(std::memory_order_relaxed);
+        stats.checksum_failures = checksum_failures.load(std::memory_order_relaxed);
+        stats.checksum_skips = checksum_skips.load(std::memory_order_relaxed);
+        stats.migrated_pages = migrated_pages.load(std::memory_order_relaxed);
+        stats.lock_acquisitions = lock_acquisitions.load(std::memory_order_relaxed);
+        stats.lock_contended = lock_contended.load(std::memory_order_relaxed);
+        stats.lock_wait_nanos = lock_wait_nanos.load(std::memory_order_relaxed);
+        stats.miss_nanos = miss_nanos.load(std::memory_order_relaxed);
+        stats.miss_latency = miss_latency.Snapshot();
+        return stats;
+    }
+
+    void PartitionStats::Reset() {
+        for (auto* counter : {&hits, &misses, &evictions, &evict_failures, &frame_waits, &frame_wait_timeouts,
+                              &frame_wait_nanos, &dirty_flushes, &bg_writer_flushes,
+                              &prefetched_pages, &checksum_failures, &checksum_skips, &migrated_pages,
+                              &lock_acquisitions, &lock_contended, &lock_wait_nanos, &miss_nanos}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        miss_latency.Reset();
+    }
+}
@@ -0,0 +1,197 @@
+#include "lightdb/checksum.h"
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define LIGHTDB_CRC32C_SSE42 1
+#endif
+namespace lightdb {
+    namespace {
+        const uint32_t CRC32C_POLY = 0x82F63B78; //反射形式的 Castagnoli 多项式
+
+        // 查表实现（slicing-by-8）：每次处理 8 字节
+        struct Crc32cTable {
+            uint32_t table[8][256];
+            Crc32cTable() {
+                for (uint32_t i = 0; i < 256; i++) {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; bit++) {
+                        crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+                    }
+                    table[0][i] = crc;
+                }
+                for (uint32_t i = 0; i < 256; i++) {
+                    for (int t = 1; t < 8; t++) {
+                        table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+                    }
+                }
+            }
+        };
+
+        uint32_t Crc32cTableImpl(const char* data, size_t length, uint32_t crc) {
+            static const Crc32cTable tables;
+            const auto& t = tables.table;
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+            crc = ~crc;
+            while (length >= 8) {
+                uint64_t word;
+                memcpy(&word, p, 8); //按小端解释
+                uint32_t low = static_cast<uint32_t>(word) ^ crc;
+                uint32_t high = static_cast<uint32_t>(word >> 32);
+                crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+                      t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+                p += 8;
+                length -= 8;
+            }
+            while (length-- > 0) {
+                crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+            }
+            return ~crc;
+        }
+
+        // GF(2) 上的多项式乘法取模（反射表示，与 zlib 的 multmodp 相同），用于合并分段计算的 CRC
+        uint32_t MultModP(uint32_t a, uint32_t b) {
+            uint32_t m = 1u << 31;
+            uint32_t p = 0;
+            while (true) {
+                if (a & m) {
+                    p ^= b;
+                    if ((a & (m - 1)) == 0) {
+                        break;
+                    }
+                }
+                m >>= 1;
+                b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+            }
+            return p;
+        }
+
+        // x^(8 * bytes) mod P：CRC 寄存器后面再接 bytes 个零字节相当于乘以它
+        uint32_t ShiftConstant(size_t bytes) {
+            uint32_t result = 1u << 31; //x^0
+            uint32_t power = 1u << 30; //x^1
+            for (size_t n = bytes * 8; n > 0; n >>= 1) {
+                if (n & 1) {
+                    result = MultModP(power, result);
+                }
+                power = MultModP(power, power);
+            }
+            return result;
+        }
+
+#ifdef LIGHTDB_CRC32C_SSE42
+        // crc32 指令延迟 3 个周期、吞吐每周期 1 条：单条依赖链只能用到三分之一，
+        // 因此把数据分成三段交错计算，最后用预先算好的 x^(8 * LANE_BYTES) 把前两段移位合并
+        const size_t LANE_BYTES = 1360; //3 段正好覆盖一个页的数据区（4080 <= PAGE_DATA_SIZE）
+
+        // 只对这些函数启用 SSE4.2，不要求整个程序以 -msse4.2 编译
+        __attribute__((target("sse4.2"))) uint32_t Crc32cSse42Serial(const char* data, size_t length, uint32_t crc) {
+#if defined(__x86_64__)
+            uint64_t crc64 = crc;
+            while (length >= 8) {
+                uint64_t word;
+                memcpy(&word, data, 8);
+                crc64 = _mm_crc32_u64(crc64, word);
+                data += 8;
+                length -= 8;
+            }
+            crc = static_cast<uint32_t>(crc64);
+#endif
+            while (length >= 4) {
+                uint32_t word;
+                memcpy(&word, data, 4);
+                crc = _mm_crc32_u32(crc, word);
+                data += 4;
+                length -= 4;
+            }
+            while (length-- > 0) {
+                crc = _mm_crc32_u8(crc, static_cast<unsigned char>(*data++));
+            }
+            return crc;
+        }
+
+        __attribute__((target("sse4.2"))) uint32_t Crc32cSse42Impl(const char* data, size_t length, uint32_t crc) {
+            crc = ~crc;
+#if defined(__x86_64__)
+            static const uint32_t lane_shift = ShiftConstant(LANE_BYTES);
+            while (length >= 3 * LANE_BYTES) {
+                uint64_t crc_a = crc;
+                uint64_t crc_b = 0;
+                uint64_t crc_c = 0;
+                for (size_t off = 0; off < LANE_BYTES; off += 8) {
+                    uint64_t a, b, c;
+                    memcpy(&a, data + off, 8);
+                    memcpy(&b, data + LANE_BYTES + off, 8);
+                    memcpy(&c, data + 2 * LANE_BYTES + off, 8);
+                    crc_a = _mm_crc32_u64(crc_a, a);
+                    crc_b = _mm_crc32_u64(crc_b, b);
+                    crc_c = _mm_crc32_u64(crc_c, c);
+                }
+                // CRC 对寄存器和数据都是线性的：后两段从 0 开始，合并时把前面的结果移过一段的长度再异或
+                crc = MultModP(lane_shift, static_cast<uint32_t>(crc_a)) ^ static_cast<uint32_t>(crc_b);
+                crc = MultModP(lane_shift, crc) ^ static_cast<uint32_t>(crc_c);
+                data += 3 * LANE_BYTES;
+                length -= 3 * LANE_BYTES;
+            }
+#endif
+            return ~Crc32cSse42Serial(data, length, crc);
+        }
+#endif
+
+        using Crc32cFn = uint32_t (*)(const char*, size_t, uint32_t);
+
+        Crc32cFn SelectImpl() {
+#ifdef LIGHTDB_CRC32C_SSE42
+            if (__builtin_cpu_supports("sse4.2")) {
+                return Crc32cSse42Impl;
+            }
+#endif
+            return Crc32cTableImpl;
+        }
+
+        // 第一次调用时选定实现，之后每次调用只是一次间接跳转（函数内静态量，不受其他编译单元静态初始化顺序影响）
+        Crc32cFn GetImpl() {
+            static const Crc32cFn impl = SelectImpl();
+            return impl;
+        }
+    }
+
+    uint32_t Crc32c(const char* data, size_t length, uint32_t crc) {
+        return GetImpl()(data, length, crc);
+    }
+
+    uint32_t Crc32cPortable(const char* data, size_t length, uint32_t crc) {
+        return Crc32cTableImpl(data, length, crc);
+    }
+
+    const char* Crc32cImplName() {
+        return GetImpl() == Crc32cTableImpl ? "table" : "sse4.2";
+    }
+
+    uint32_t ComputePageChecksum(const char* page, int32_t page_no) {
+        uint32_t crc = Crc32c(page, PAGE_DATA_SIZE);
+        return Crc32c(reinterpret_cast<const char*>(&page_no), sizeof(page_no), crc);
+    }
+
+    void SetPageChecksum(char* page, int32_t page_no) {
+        uint32_t checksum = ComputePageChecksum(page, page_no);
+        memcpy(page + PAGE_DATA_SIZE, &checksum, PAGE_CHECKSUM_SIZE);
+    }
+
+    bool VerifyPageChecksum(const char* page, int32_t page_no) {
+        uint32_t stored;
+        memcpy(&stored, page + PAGE_DATA_SIZE, PAGE_CHECKSUM_SIZE);
+        if (stored == ComputePageChecksum(page, page_no)) {
+            return true;
+        }
+        if (stored != 0) {
+            return false;
+        }
+        // 校验和为 0 时可能是从未写过的全零页
+        for (int i = 0; i < PAGE_DATA_SIZE; i++) {
+            if (page[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,252 @@
+#include "lightdb/compressed_file.h"
+#include "lightdb/io_engine.h"
+#include "lightdb/logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+namespace lightdb {
+    static_assert(PAGE_SIZE % CompressedPageFile::SECTOR_SIZE == 0, "page must consist of whole sectors");
+
+    CompressedPageFile::CompressedPageFile(int data_fd, const std::string& map_path, PageCompression compression)
+        : data_fd_(data_fd), map_fd_(-1), map_path_(map_path), compression_(compression), free_(MAX_SECTORS + 1) {
+        map_fd_ = open(map_path_.c_str(), O_RDWR | O_CREAT, 0644);
+        if (map_fd_ < 0) {
+            LOG_ERROR("Open page map failed: " + map_path_ + ", " + std::strerror(errno));
+            return;
+        }
+        if (!LoadMap()) {
+            close(map_fd_);
+            map_fd_ = -1;
+            return;
+        }
+        RebuildFreeLists();
+    }
+
+    CompressedPageFile::~CompressedPageFile() {
+        if (map_fd_ < 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        CheckpointLocked();
+        close(map_fd_);
+    }
+
+    bool CompressedPageFile::LoadMap() {
+        struct stat map_st;
+        struct stat data_st;
+        if (fstat(map_fd_, &map_st) != 0 || fstat(data_fd_, &data_st) != 0) {
+            LOG_ERROR("Stat page map failed: " + map_path_ + ", " + std::strerror(errno));
+            return false;
+        }
+        if (map_st.st_size == 0) {
+            // 没有映射的非空数据文件是以未压缩方式建立的，不能当作压缩文件打开
+            if (data_st.st_size > 0) {
+                LOG_ERROR("Page map " + map_path_ + " is missing for a non-empty data file");
+                return false;
+            }
+            MapHeader header{MAP_MAGIC, MAP_VERSION, 0, 0};
+            return PwriteFull(map_fd_, reinterpret_cast<const char*>(&header), sizeof(header), 0);
+        }
+        MapHeader header;
+        if (!PreadFull(map_fd_, reinterpret_cast<char*>(&header), sizeof(header), 0) ||
+            header.magic != MAP_MAGIC || header.version != MAP_VERSION) {
+            LOG_ERROR("Page map " + map_path_ + " has an invalid header");
+            return false;
+        }
+        map_.resize(header.num_pages);
+        if (!map_.empty() && !PreadFull(map_fd_, reinterpret_cast<char*>(map_.data()), map_.size() * sizeof(Extent),
+                                        sizeof(MapHeader))) {
+            LOG_ERROR("Page map " + map_path_ + " is truncated");
+            return false;
+        }
+        for (const Extent& extent : map_) {
+            if (extent.length == 0) {
+                continue;
+            }
+            if (extent.num_sectors == 0 || extent.num_sectors > MAX_SECTORS ||
+                extent.length > extent.num_sectors * SECTOR_SIZE) {
+                LOG_ERROR("Page map " + map_path_ + " has a corrupted entry");
+                return false;
+            }
+            logical_bytes_ += PAGE_SIZE;
+            physical_bytes_ += extent.num_sectors * SECTOR_SIZE;
+        }
+        return true;
+    }
+
+    void CompressedPageFile::RebuildFreeLists() {
+        // 按起始扇区排序已使用的槽，槽之间的空洞即为空闲空间（上次运行中被替换的旧槽）
+        std::vector<Extent> used;
+        for (const Extent& extent : map_) {
+            if (extent.length != 0) {
+                used.push_back(extent);
+            }
+        }
+        std::sort(used.begin(), used.end(), [](const Extent& a, const Extent& b) { return a.sector < b.sector; });
+        uint32_t cursor = 0;
+        for (const Extent& extent : used) {
+            while (cursor < extent.sector) {
+                int num_sectors = static_cast<int>(std::min<uint32_t>(extent.sector - cursor, MAX_SECTORS));
+                AddFree(cursor, num_sectors);
+                cursor += num_sectors;
+            }
+            cursor = std::max(cursor, extent.sector + extent.num_sectors);
+        }
+        end_sector_ = cursor;
+    }
+
+    CompressedPageFile::Extent CompressedPageFile::Allocate(int num_sectors) {
+        // 先找大小正好的空闲槽，再拆分更大的，都没有时追加到文件末尾
+        for (int size = num_sectors; size <= MAX_SECTORS; size++) {
+            if (free_[size].empty()) {
+                continue;
+            }
+            uint32_t sector = free_[size].back();
+            free_[size].pop_back();
+            if (size > num_sectors) {
+                AddFree(sector + num_sectors, size - num_sectors);
+            }
+            return {sector, static_cast<uint16_t>(num_sectors), 0};
+        }
+        Extent extent{end_sector_, static_cast<uint16_t>(num_sectors), 0};
+        end_sector_ += num_sectors;
+        return extent;
+    }
+
+    void CompressedPageFile::AddFree(uint32_t sector, int num_sectors) {
+        free_[num_sectors].push_back(sector);
+    }
+
+    bool CompressedPageFile::ReadPage(int32_t page_no, char* page_data) {
+        Extent extent{0, 0, 0};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (page_no >= 0 && static_cast<size_t>(page_no) < map_.size()) {
+                extent = map_[page_no];
+            }
+        }
+        if (extent.length == 0) {
+            memset(page_data, 0, PAGE_SIZE);
+            return true;
+        }
+        off_t offset = static_cast<off_t>(extent.sector) * SECTOR_SIZE;
+        if (extent.length == PAGE_SIZE) {
+            if (!PreadFull(data_fd_, page_data, PAGE_SIZE, offset)) {
+                LOG_ERROR("ReadPage failed: compressed page " + std::to_string(page_no) + ", " + std::strerror(errno));
+                return false;
+            }
+            return true;
+        }
+        char buffer[PAGE_SIZE];
+        if (!PreadFull(data_fd_, buffer, extent.num_sectors * SECTOR_SIZE, offset)) {
+            LOG_ERROR("ReadPage failed: compressed page " + std::to_string(page_no) + ", " + std::strerror(errno));
+            return false;
+        }
+        if (LzDecompress(buffer, extent.length, page_data, PAGE_SIZE) != PAGE_SIZE) {
+            LOG_ERROR("ReadPage failed: compressed page " + std::to_string(page_no) + " is corrupted");
+            return false;
+        }
+        return true;
+    }
+
+    bool CompressedPageFile::WritePage(int32_t page_no, const char* page_data) {
+        if (page_no < 0) {
+            return false;
+        }
+        // 压缩后至少要省下一个扇区，否则原样存储，读取时也省去解压
+        char buffer[PAGE_SIZE];
+        int length = 0;
+        if (compression_ == PageCompression::LZ) {
+            length = LzCompress(page_data, PAGE_SIZE, buffer, PAGE_SIZE - SECTOR_SIZE);
+        }
+        const char* source = buffer;
+        if (length == 0) {
+            length = PAGE_SIZE;
+            source = page_data;
+        }
+        int num_sectors = (length + SECTOR_SIZE - 1) / SECTOR_SIZE;
+        if (source == buffer) {
+            memset(buffer + length, 0, num_sectors * SECTOR_SIZE - length);
+        }
+
+        Extent extent;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            extent = Allocate(num_sectors);
+        }
+        extent.length = static_cast<uint16_t>(length);
+        off_t offset = static_cast<off_t>(extent.sector) * SECTOR_SIZE;
+        if (!PwriteFull(data_fd_, source, num_sectors * SECTOR_SIZE, offset)) {
+            LOG_ERROR("WritePage failed: compressed page " + std::to_string(page_no) + ", " + std::strerror(errno));
+            std::lock_guard<std::mutex> lock(mutex_);
+            AddFree(extent.sector, num_sectors);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t first_dirty = page_no;
+        if (static_cast<size_t>(page_no) >= map_.size()) {
+            first_dirty = map_.size(); //中间跳过的页也要写入映射文件（全零项）
+            map_.resize(page_no + 1, Extent{0, 0, 0});
+        }
+        Extent old = map_[page_no];
+        if (old.length != 0) {
+            pending_free_.push_back(old);
+            physical_bytes_ -= old.num_sectors * SECTOR_SIZE;
+        } else {
+            logical_bytes_ += PAGE_SIZE;
+        }
+        map_[page_no] = extent;
+        physical_bytes_ += num_sectors * SECTOR_SIZE;
+        if (dirty_begin_ >= dirty_end_) {
+            dirty_begin_ = first_dirty;
+            dirty_end_ = page_no + 1;
+        } else {
+            dirty_begin_ = std::min(dirty_begin_, first_dirty);
+            dirty_end_ = std::max(dirty_end_, static_cast<size_t>(page_no) + 1);
+        }
+        if (pending_free_.size() >= CHECKPOINT_PENDING) {
+            CheckpointLocked();
+        }
+        return true;
+    }
+
+    int32_t CompressedPageFile::GetNumPages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<int32_t>(map_.size());
+    }
+
+    bool CompressedPageFile::Sync() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return CheckpointLocked();
+    }
+
+    bool CompressedPageFile::CheckpointLocked() {
+        if (dirty_begin_ < dirty_end_) {
+            // 新槽中的数据先落盘，映射再指向它们
+            if (fdatasync(data_fd_) != 0) {
+                LOG_ERROR("Sync compressed data failed: " + std::string(std::strerror(errno)));
+                return false;
+            }
+            MapHeader header{MAP_MAGIC, MAP_VERSION, static_cast<uint32_t>(map_.size()), 0};
+            off_t offset = sizeof(MapHeader) + dirty_begin_ * sizeof(Extent);
+            if (!PwriteFull(map_fd_, reinterpret_cast<const char*>(map_.data() + dirty_begin_),
+                            (dirty_end_ - dirty_begin_) * sizeof(Extent), offset) ||
+                !PwriteFull(map_fd_, reinterpret_cast<const char*>(&header), sizeof(header), 0) ||
+                fdatasync(map_fd_) != 0) {
+                LOG_ERROR("Write page map failed: " + map_path_ + ", " + std::strerror(errno));
+                return false;
+            }
+            dirty_begin_ = dirty_end_ = 0;
+        }
+        // 映射已不再引用旧槽，可以复用
+        for (const Extent& extent : pending_free_) {
+            AddFree(extent.sector, extent.num_sectors);
+        }
+        pending_free_.clear();
+        return true;
+    }
+}
@@ -0,0 +1,317 @@
+#include "lightdb/disk_manager.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <condition_variable>
+namespace lightdb {
+    namespace {
+        // O_DIRECT 要求缓冲区按扇区对齐，未对齐时借助线程私有的对齐缓冲区中转
+        const size_t DIRECT_IO_ALIGNMENT = 4096;
+
+        char* GetBounceBuffer() {
+            alignas(DIRECT_IO_ALIGNMENT) static thread_local char buffer[PAGE_SIZE];
+            return buffer;
+        }
+
+        bool IsAligned(const void* ptr) {
+            return reinterpret_cast<uintptr_t>(ptr) % DIRECT_IO_ALIGNMENT == 0;
+        }
+
+        // 异步完成时 pages 可能已被调用方释放，回调只能持有 PageID 的副本
+        std::function<void(size_t, bool)> ByPageID(const std::vector<PageIO>& pages, const PageIOCallback& callback) {
+            auto page_ids = std::make_shared<std::vector<PageID>>();
+            page_ids->reserve(pages.size());
+            for (const auto& io : pages) {
+                page_ids->push_back(io.page_id);
+            }
+            return [page_ids, callback](size_t index, bool ok) { callback((*page_ids)[index], ok); };
+        }
+    }
+
+    DiskManager::DiskManager(bool use_direct_io, IOEngineType io_engine)
+        : use_direct_io_(use_direct_io), io_engine_(MakeIOEngine(io_engine)) {}
+
+    DiskManager::~DiskManager() {
+        // 先停掉 I/O 引擎（等待在途请求完成）并等待在途的同步结束，再关闭文件
+        io_engine_.reset();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            syncs_done_.wait(lock, [this]() { return syncs_in_flight_ == 0; });
+        }
+        for (auto& file : files_) {
+            file.compressed.reset(); //持久化页映射，之后才能关闭数据文件
+            if (file.fd >= 0) {
+                fsync(file.fd);
+                close(file.fd);
+            }
+        }
+    }
+
+    FileID DiskManager::OpenFile(const std::string& file_path, PageCompression compression) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < files_.size(); i++) {
+            if (files_[i].path == file_path) {
+                if ((compression != PageCompression::NONE) != (files_[i].compressed != nullptr)) {
+                    LOG_WARN("OpenFile: " + file_path + " is already open with a different compression");
+                }
+                return static_cast<FileID>(i);
+            }
+        }
+        if (files_.size() >= (1u << (31 - PAGE_NO_BITS))) {
+            LOG_ERROR("OpenFile failed: too many open files");
+            return INVALID_FILE_ID;
+        }
+
+        // 压缩页占用的槽按 512 字节扇区对齐，不满足所有设备的 O_DIRECT 对齐要求
+        bool direct_io = use_direct_io_ && compression == PageCompression::NONE;
+        int flags = O_RDWR | O_CREAT;
+        int fd = -1;
+#ifdef O_DIRECT
+        if (direct_io) {
+            fd = open(file_path.c_str(), flags | O_DIRECT, 0644);
+            if (fd < 0) {
+                // 部分文件系统(如 tmpfs)不支持 O_DIRECT，退回到普通缓冲 I/O
+                LOG_WARN("O_DIRECT not supported for " + file_path + ", fallback to buffered I/O");
+                direct_io = false;
+            }
+        }
+#else
+        direct_io = false;
+#endif
+        if (fd < 0) {
+            fd = open(file_path.c_str(), flags, 0644);
+        }
+        if (fd < 0) {
+            LOG_ERROR("OpenFile failed: " + file_path + ", " + std::strerror(errno));
+            return INVALID_FILE_ID;
+        }
+        std::unique_ptr<CompressedPageFile> compressed;
+        if (compression != PageCompression::NONE) {
+            compressed = std::make_unique<CompressedPageFile>(fd, file_path + ".pmap", compression);
+            if (!compressed->IsValid()) {
+                LOG_ERROR("OpenFile failed: " + file_path + " cannot be opened as a compressed file");
+                close(fd);
+                return INVALID_FILE_ID;
+            }
+        }
+        files_.push_back({file_path, fd, direct_io, std::move(compressed)});
+        LOG_INFO("Open file " + file_path + " as file " + std::to_string(files_.size() - 1));
+        return static_cast<FileID>(files_.size() - 1);
+    }
+
+    int DiskManager::GetFd(PageID page_id, bool* direct_io, CompressedPageFile** compressed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        FileID file_id = GetFileID(page_id);
+        if (page_id < 0 || file_id >= static_cast<FileID>(files_.size())) {
+            return -1;
+        }
+        *direct_io = files_[file_id].direct_io;
+        if (compressed != nullptr) {
+            *compressed = files_[file_id].compressed.get();
+        }
+        return files_[file_id].fd;
+    }
+
+    bool DiskManager::IsDirectIO(FileID file_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return file_id >= 0 && file_id < static_cast<FileID>(files_.size()) && files_[file_id].direct_io;
+    }
+
+    bool DiskManager::IsCompressed(FileID file_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return file_id >= 0 && file_id < static_cast<FileID>(files_.size()) && files_[file_id].compressed != nullptr;
+    }
+
+    bool DiskManager::GetCompressionStats(FileID file_id, uint64_t* logical_bytes, uint64_t* physical_bytes) {
+        CompressedPageFile* compressed = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (file_id < 0 || file_id >= static_cast<FileID>(files_.size())) {
+                return false;
+            }
+            compressed = files_[file_id].compressed.get();
+        }
+        if (compressed == nullptr) {
+            *logical_bytes = *physical_bytes = static_cast<uint64_t>(GetNumPages(file_id)) * PAGE_SIZE;
+            return true;
+        }
+        *logical_bytes = compressed->GetLogicalBytes();
+        *physical_bytes = compressed->GetPhysicalBytes();
+        return true;
+    }
+
+    bool DiskManager::ReadPage(PageID page_id, char* page_data) {
+        bool direct_io = false;
+        CompressedPageFile* compressed = nullptr;
+        int fd = GetFd(page_id, &direct_io, &compressed);
+        if (fd < 0) {
+            LOG_ERROR("ReadPage failed: page " + std::to_string(page_id) + " has no open file");
+            return false;
+        }
+        if (compressed != nullptr) {
+            return compressed->ReadPage(GetPageNo(page_id), page_data);
+        }
+        char* buffer = (direct_io && !IsAligned(page_data)) ? GetBounceBuffer() : page_data;
+        off_t offset = static_cast<off_t>(GetPageNo(page_id)) * PAGE_SIZE;
+        if (!PreadFull(fd, buffer, PAGE_SIZE, offset)) {
+            LOG_ERROR("ReadPage failed: page " + std::to_string(page_id) + ", " + std::strerror(errno));
+            return false;
+        }
+        if (buffer != page_data) {
+            memcpy(page_data, buffer, PAGE_SIZE);
+        }
+        return true;
+    }
+
+    bool DiskManager::WritePage(PageID page_id, const char* page_data) {
+        bool direct_io = false;
+        CompressedPageFile* compressed = nullptr;
+        int fd = GetFd(page_id, &direct_io, &compressed);
+        if (fd < 0) {
+            LOG_ERROR("WritePage failed: page " + std::to_string(page_id) + " has no open file");
+            return false;
+        }
+        if (compressed != nullptr) {
+            return compressed->WritePage(GetPageNo(page_id), page_data);
+        }
+        const char* buffer = page_data;
+        if (direct_io && !IsAligned(page_data)) {
+            char* bounce = GetBounceBuffer();
+            memcpy(bounce, page_data, PAGE_SIZE);
+            buffer = bounce;
+        }
+        off_t offset = static_cast<off_t>(GetPageNo(page_id)) * PAGE_SIZE;
+        if (!PwriteFull(fd, buffer, PAGE_SIZE, offset)) {
+            LOG_ERROR("WritePage failed: page " + std::to_string(page_id) + ", " + std::strerror(errno));
+            return false;
+        }
+        return true;
+    }
+
+    void DiskManager::SubmitPages(const std::vector<PageIO>& pages, bool is_write,
+                                  const std::function<void(size_t index, bool ok)>& callback) {
+        std::vector<IORequest> requests;
+        requests.reserve(pages.size());
+        for (size_t i = 0; i < pages.size(); i++) {
+            const PageIO& io = pages[i];
+            PageID page_id = io.page_id;
+            bool direct_io = false;
+            CompressedPageFile* compressed = nullptr;
+            int fd = GetFd(page_id, &direct_io, &compressed);
+            if (fd < 0) {
+                LOG_ERROR("SubmitPages failed: page " + std::to_string(page_id) + " has no open file");
+                callback(i, false);
+                continue;
+            }
+            if (compressed != nullptr) {
+                // 压缩页的物理位置和长度要压缩/查映射后才知道，直接同步完成
+                bool ok = is_write ? compressed->WritePage(GetPageNo(page_id), io.data)
+                                   : compressed->ReadPage(GetPageNo(page_id), io.data);
+                callback(i, ok);
+                continue;
+            }
+            off_t offset = static_cast<off_t>(GetPageNo(page_id)) * PAGE_SIZE;
+            if (direct_io && !IsAligned(io.data)) {
+                // O_DIRECT 下缓冲区未对齐：每个请求使用自己的对齐中转缓冲区，完成后再拷贝/释放
+                char* bounce = static_cast<char*>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, PAGE_SIZE));
+                char* data = io.data;
+                if (is_write) {
+                    memcpy(bounce, data, PAGE_SIZE);
+                }
+                requests.push_back({is_write, fd, offset, bounce, static_cast<size_t>(PAGE_SIZE),
+                                    [callback, i, bounce, data, is_write](bool ok) {
+                                        if (ok && !is_write) {
+                                            memcpy(data, bounce, PAGE_SIZE);
+                                        }
+                                        std::free(bounce);
+                                        callback(i, ok);
+                                    }});
+                continue;
+            }
+            requests.push_back({is_write, fd, offset, io.data, static_cast<size_t>(PAGE_SIZE),
+                                [callback, i](bool ok) { callback(i, ok); }});
+        }
+        if (!requests.empty()) {
+            io_engine_->Submit(requests);
+        }
+    }
+
+    bool DiskManager::SubmitPagesAndWait(std::vector<PageIO>& pages, bool is_write) {
+        // 计数器在本函数栈上，回调须在持锁时通知，保证本函数返回前回调已不再访问它
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining = pages.size();
+        bool all_ok = true;
+        SubmitPages(pages, is_write, [&](size_t index, bool ok) {
+            std::lock_guard<std::mutex> lock(mutex);
+            pages[index].ok = ok;
+            all_ok = all_ok && ok;
+            if (--remaining == 0) {
+                done.notify_all();
+            }
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&remaining]() { return remaining == 0; });
+        return all_ok;
+    }
+
+    void DiskManager::ReadPagesAsync(const std::vector<PageIO>& pages, const PageIOCallback& callback) {
+        SubmitPages(pages, false, ByPageID(pages, callback));
+    }
+
+    void DiskManager::WritePagesAsync(const std::vector<PageIO>& pages, const PageIOCallback& callback) {
+        SubmitPages(pages, true, ByPageID(pages, callback));
+    }
+
+    bool DiskManager::ReadPages(std::vector<PageIO>& pages) {
+        return SubmitPagesAndWait(pages, false);
+    }
+
+    bool DiskManager::WritePages(std::vector<PageIO>& pages) {
+        return SubmitPagesAndWait(pages, true);
+    }
+
+    int32_t DiskManager::GetNumPages(FileID file_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_id < 0 || file_id >= static_cast<FileID>(files_.size())) {
+            return 0;
+        }
+        if (files_[file_id].compressed != nullptr) {
+            return files_[file_id].compressed->GetNumPages();
+        }
+        struct stat st;
+        if (fstat(files_[file_id].fd, &st) != 0) {
+            return 0;
+        }
+        return static_cast<int32_t>((st.st_size + PAGE_SIZE - 1) / PAGE_SIZE);
+    }
+
+    void DiskManager::SyncFile(FileID file_id) {
+        int fd;
+        CompressedPageFile* compressed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (file_id < 0 || file_id >= static_cast<FileID>(files_.size())) {
+                return;
+            }
+            fd = files_[file_id].fd;
+            compressed = files_[file_id].compressed.get();
+            syncs_in_flight_++;
+        }
+        // fdatasync 可能很久，在锁外进行；GetFd 每次读写都要获取 mutex_
+        if (compressed != nullptr) {
+            compressed->Sync(); //先同步数据文件，再写入页映射
+        } else {
+            fdatasync(fd);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            syncs_in_flight_--;
+        }
+        syncs_done_.notify_all();
+    }
+}
@@ -0,0 +1,145 @@
+#include "lightdb/free_space_map.h"
+#include <algorithm>
+#include <cstring>
+namespace lightdb {
+    namespace {
+        const int MAX_CATEGORY = 254; //取值为档位 + 1，须放得进一个字节
+        const int32_t ENTRIES_PER_PAGE = PAGE_DATA_SIZE;
+    }
+
+    FreeSpaceMap::FreeSpaceMap(const std::string& path, BufferPool* buffer_pool, int32_t num_heap_pages,
+                               const std::function<int(int32_t page_no)>& read_free_space)
+        : path_(path), buffer_pool_(buffer_pool) {
+        file_id_ = buffer_pool_->GetDiskManager()->OpenFile(path_);
+        if (file_id_ == INVALID_FILE_ID) {
+            LOG_ERROR("Open free space map " + path_ + " failed, it will not be persisted");
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tree_.assign(2 * leaves_, 0);
+            Grow(num_heap_pages);
+        }
+        int32_t rebuilt = 0;
+        std::vector<uint8_t> entries(ENTRIES_PER_PAGE);
+        for (int32_t fsm_page = 0; fsm_page * ENTRIES_PER_PAGE < num_heap_pages; fsm_page++) {
+            std::fill(entries.begin(), entries.end(), 0);
+            if (file_id_ != INVALID_FILE_ID) {
+                ReadPageGuard guard = buffer_pool_->FetchPageRead(MakePageID(file_id_, fsm_page));
+                if (guard) {
+                    memcpy(entries.data(), guard.GetData(), ENTRIES_PER_PAGE);
+                }
+            }
+            // 先释放 FSM 页再读堆页，未记录的项读出后逐个写回
+            int32_t end = std::min(num_heap_pages, (fsm_page + 1) * ENTRIES_PER_PAGE);
+            for (int32_t page_no = fsm_page * ENTRIES_PER_PAGE; page_no < end; page_no++) {
+                uint8_t value = entries[page_no % ENTRIES_PER_PAGE];
+                bool missing = value == 0;
+                if (missing) {
+                    value = Encode(read_free_space(page_no));
+                    rebuilt++;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    SetLeaf(page_no, value);
+                }
+                if (missing) {
+                    Persist(page_no);
+                }
+            }
+        }
+        if (rebuilt > 0) {
+            LOG_INFO("Rebuilt " + std::to_string(rebuilt) + " entries of free space map " + path_);
+        }
+    }
+
+    int32_t FreeSpaceMap::FindPage(int required) {
+        int category = (std::max(required, 0) + FSM_CATEGORY_BYTES - 1) / FSM_CATEGORY_BYTES;
+        if (category > MAX_CATEGORY) {
+            return -1;
+        }
+        uint8_t needed = static_cast<uint8_t>(category + 1);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tree_[1] < needed) {
+            return -1;
+        }
+        // 自根向下，左子树满足时优先走左边，找到页号最小的页
+        size_t node = 1;
+        while (node < leaves_) {
+            node = tree_[2 * node] >= needed ? 2 * node : 2 * node + 1;
+        }
+        return static_cast<int32_t>(node - leaves_);
+    }
+
+    void FreeSpaceMap::Update(int32_t page_no, int free_space) {
+        uint8_t value = Encode(free_space);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Grow(page_no + 1);
+            if (tree_[leaves_ + page_no] == value) {
+                return; //档位未变，不必弄脏 FSM 页
+            }
+            SetLeaf(page_no, value);
+        }
+        // 释放 mutex_ 后再写回：取 FSM 页可能未命中、淘汰脏页或等待空闲帧，不能让整张表的插入删除排在它后面
+        Persist(page_no);
+    }
+
+    uint8_t FreeSpaceMap::Encode(int free_space) {
+        int category = std::min(std::max(free_space, 0) / FSM_CATEGORY_BYTES, MAX_CATEGORY);
+        return static_cast<uint8_t>(category + 1);
+    }
+
+    void FreeSpaceMap::Grow(int32_t num_pages) {
+        if (num_pages <= num_pages_) {
+            return;
+        }
+        num_pages_ = num_pages;
+        if (static_cast<size_t>(num_pages) <= leaves_) {
+            return;
+        }
+        // 叶子数翻倍直到放得下，按新的布局重建整棵树
+        size_t new_leaves = leaves_;
+        while (new_leaves < static_cast<size_t>(num_pages)) {
+            new_leaves *= 2;
+        }
+        std::vector<uint8_t> tree(2 * new_leaves, 0);
+        std::copy(tree_.begin() + leaves_, tree_.end(), tree.begin() + new_leaves);
+        for (size_t node = new_leaves - 1; node >= 1; node--) {
+            tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+        }
+        tree_.swap(tree);
+        leaves_ = new_leaves;
+    }
+
+    void FreeSpaceMap::SetLeaf(int32_t page_no, uint8_t value) {
+        size_t node = leaves_ + page_no;
+        tree_[node] = value;
+        // 向上更新最大值，某一层不变时更高层也不会变
+        for (node /= 2; node >= 1; node /= 2) {
+            uint8_t max_value = std::max(tree_[2 * node], tree_[2 * node + 1]);
+            if (tree_[node] == max_value) {
+                break;
+            }
+            tree_[node] = max_value;
+        }
+    }
+
+    bool FreeSpaceMap::Persist(int32_t page_no) {
+        if (file_id_ == INVALID_FILE_ID) {
+            return false;
+        }
+        WritePageGuard guard = buffer_pool_->FetchPageWrite(MakePageID(file_id_, page_no / ENTRIES_PER_PAGE));
+        if (!guard) {
+            LOG_ERROR("Update free space map " + path_ + " failed: page not available");
+            return false;
+        }
+        // 在 FSM 页的写闩内取线段树中的当前值：同一项并发写回时，最后写回的一定是最新的值
+        uint8_t value;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            value = tree_[leaves_ + page_no];
+        }
+        guard.GetDataMut()[page_no % ENTRIES_PER_PAGE] = static_cast<char>(value);
+        return true;
+    }
+}
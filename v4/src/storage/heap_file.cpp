@@ -1,162 +1,469 @@
 #include "lightdb/heap_file.h"
+#include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <thread>
+#include <utility>
 namespace lightdb {
+    namespace {
+        HeapPageHeader ReadPageHeader(const char* data) {
+            HeapPageHeader header;
+            memcpy(&header, data, sizeof(HeapPageHeader));
+            if (header.data_begin == 0) {
+                header.data_begin = PAGE_DATA_SIZE; //新分配的页全为零
+            }
+            return header;
+        }
+
+        // 第 slot_id 个槽的位置是固定的，读取记录不需要遍历前面的记录
+        const char* SlotAddress(const char* data, int slot_id) {
+            return data + sizeof(HeapPageHeader) + static_cast<size_t>(slot_id) * sizeof(HeapSlot);
+        }
+
+        HeapSlot ReadSlotEntry(const char* data, int slot_id) {
+            HeapSlot slot;
+            memcpy(&slot, SlotAddress(data, slot_id), sizeof(HeapSlot));
+            return slot;
+        }
+
+        void WriteSlotEntry(char* data, int slot_id, const HeapSlot& slot) {
+            memcpy(const_cast<char*>(SlotAddress(data, slot_id)), &slot, sizeof(HeapSlot));
+        }
+
+        // 第一个已删除、可以复用的槽，没有时返回 -1
+        int FindDeletedSlot(const char* data, int slot_count) {
+            for (int i = 0; i < slot_count; ++i) {
+                if (ReadSlotEntry(data, i).flags & HEAP_SLOT_DELETED) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+    }
+
+    HeapFile::HeapFile(const std::string& file_path, BufferPool* buffer_pool, StorageMode mode,
+                       PageCompression compression)
+        : file_path_(file_path), buffer_pool_(buffer_pool), next_page_id_(0), mode_(mode), compression_(compression) {
+        if (mode_ == StorageMode::MMAP_READ_ONLY && compression_ != PageCompression::NONE) {
+            LOG_WARN("Table " + file_path_ + " is compressed and cannot be mapped, using the buffer pool");
+            mode_ = StorageMode::BUFFER_POOL;
+        }
+        file_id_ = buffer_pool_->GetDiskManager()->OpenFile(file_path_, compression_);
+        next_page_id_ = buffer_pool_->GetDiskManager()->GetNumPages(file_id_);
+        if (mode_ == StorageMode::MMAP_READ_ONLY) {
+            mmap_file_ = std::make_unique<MmapFile>(file_path_);
+        } else {
+            auto read_free_space = [this](int32_t page_no) {
+                ReadPageGuard guard = buffer_pool_->FetchPageRead(MakePageID(file_id_, page_no));
+                return guard ? GetFreeSpace(guard.GetData()) : 0;
+            };
+            fsm_ = std::make_unique<FreeSpaceMap>(file_path_ + ".fsm", buffer_pool_, next_page_id_, read_free_space);
+        }
+    }
     RID HeapFile::InsertRecord(const Record& record) {
-         Page* page = GetFreePage(record);
-        if (page == nullptr) {
+        std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
+        if (mode_ == StorageMode::MMAP_READ_ONLY) {
+            LOG_ERROR("InsertRecord failed: table " + file_path_ + " is read-only");
+            return RID();
+        }
+        // 空页也放不下的记录直接拒绝，否则 GetFreePage 每次都会新建一页
+        if (sizeof(HeapSlot) + record.data.size() > PAGE_DATA_SIZE - sizeof(HeapPageHeader)) {
+            LOG_ERROR("InsertRecord failed: record of " + std::to_string(record.data.size()) +
+                      " bytes does not fit in a page");
+            return RID();
+        }
+        WritePageGuard guard = GetFreePage(record);
+        if (!guard) {
             LOG_ERROR("InsertRecord failed: no free page available");
             return RID();
         }
-
-        int required_space = sizeof(RecordHeader) + record.data.size();
-        if (page->GetFreeSpace() < required_space) {
-            LOG_ERROR("Page " + std::to_string(page->page_id) + " has no enough space");
-            buffer_pool_->UnpinPage(page->page_id, false);
+        int required_space = sizeof(HeapSlot) + record.data.size();
+        if (GetFreeSpace(guard.GetData()) < required_space) {
+            LOG_ERROR("Page " + std::to_string(guard.GetPageID()) + " has no enough space");
             return RID();
         }
+        char* page_data = guard.GetDataMut(); // 标记脏页
 
-        // 序列化记录到页面
-        char* data = page->GetData() + (PAGE_SIZE - page->GetFreeSpace()); // 从空闲空间起始位置写入
-        int record_len = SerializeRecord(record, data);
-
-        // 更新页面元数据
-        page->record_count++;
-        page->used_data_size += record.data.size();  // 需在Page中新增used_data_size字段
+        // 记录数据写在数据区前面；优先复用已删除的槽，没有时把槽追加到槽数组末尾
+        HeapPageHeader page_header = ReadPageHeader(page_data);
+        int slot_id = FindDeletedSlot(page_data, page_header.slot_count);
+        if (slot_id < 0) {
+            slot_id = page_header.slot_count++;
+        }
+        page_header.data_begin -= static_cast<int32_t>(record.data.size());
+        memcpy(page_data + page_header.data_begin, record.data.data(), record.data.size());
+        HeapSlot slot{static_cast<uint16_t>(page_header.data_begin), static_cast<uint16_t>(record.data.size()), 0};
+        WriteSlotEntry(page_data, slot_id, slot);
 
-        RID rid(page->page_id, page->record_count - 1); // slot_id为记录索引
+        // 更新页头
+        memcpy(page_data, &page_header, sizeof(HeapPageHeader));
+        int free_space = GetFreeSpace(page_data);
+        RID rid(guard.GetPageID(), slot_id); // slot_id 为槽号
+        guard.Drop(); // 解闩并以脏页 unpin；FSM 只是提示，先放开数据页再更新
+        fsm_->Update(GetPageNo(rid.page_id), free_space);
         LOG_INFO("Insert record to RID: " + rid.ToString());
-
-        buffer_pool_->UnpinPage(page->page_id, true); // 标记脏页
         return rid;
     }
     Record HeapFile::ReadRecord(const RID& rid) {
-        Page* page = buffer_pool_->FetchPage(rid.page_id);
-        if (page == nullptr) {
+        RecordRef ref = ReadRecordRef(rid);
+        return ref ? ref.ToRecord() : Record();
+    }
+    RecordRef HeapFile::ReadRecordRef(const RID& rid) {
+        std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
+        RecordRef ref;
+        if (mode_ == StorageMode::MMAP_READ_ONLY) {
+            // 映射模式：页访问只是指针运算，映射在表关闭前一直有效，不需要守卫
+            const char* data = mmap_file_->GetPage(GetPageNo(rid.page_id));
+            if (data == nullptr) {
+                LOG_ERROR("ReadRecord failed: page " + std::to_string(rid.page_id) + " not found");
+                return ref;
+            }
+            if (ReadSlot(data, rid.slot_id, &ref.data_)) {
+                ref.rid_ = rid;
+            }
+            return ref;
+        }
+        ReadPageGuard guard = buffer_pool_->FetchPageRead(rid.page_id);
+        if (!guard) {
             LOG_ERROR("ReadRecord failed: page " + std::to_string(rid.page_id) + " not found");
-            return Record();
+            return ref;
+        }
+        if (ReadSlot(guard.GetData(), rid.slot_id, &ref.data_)) {
+            ref.rid_ = rid;
+            ref.guard_ = std::move(guard);
+        }
+        return ref;
+    }
+    bool HeapFile::DeleteRecord(const RID& rid) {
+        std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
+        if (mode_ == StorageMode::MMAP_READ_ONLY) {
+            LOG_ERROR("DeleteRecord failed: table " + file_path_ + " is read-only");
+            return false;
+        }
+        WritePageGuard guard = buffer_pool_->FetchPageWrite(rid.page_id);
+        if (!guard) {
+            LOG_ERROR("DeleteRecord failed: page not found");
+            return false;
+        }
+        HeapPageHeader page_header = ReadPageHeader(guard.GetData());
+        if (rid.slot_id < 0 || rid.slot_id >= page_header.slot_count) {
+            LOG_ERROR("Invalid slot_id: " + std::to_string(rid.slot_id));
+            return false;
         }
+        HeapSlot slot = ReadSlotEntry(guard.GetData(), rid.slot_id);
+        if (slot.flags & HEAP_SLOT_DELETED) {
+            LOG_ERROR("DeleteRecord failed: RID " + rid.ToString() + " is already deleted");
+            return false;
+        }
+        // 槽上置删除标记后整理页内空间，槽号保持不变；腾出的空间记入 FSM
+        slot.flags |= HEAP_SLOT_DELETED;
+        char* page_data = guard.GetDataMut(); // 标记脏页
+        WriteSlotEntry(page_data, rid.slot_id, slot);
+        CompactPage(page_data);
+        int free_space = GetFreeSpace(page_data);
+        guard.Drop();
+        fsm_->Update(GetPageNo(rid.page_id), free_space);
+        LOG_INFO("Delete record at RID: " + rid.ToString());
+        return true;
+    }
 
-        char* current = page->GetData();
-        RecordHeader header;
+    std::vector<Record> HeapFile::SeqScan() {
+        std::vector<Record> records;
+        TableIterator it = Scan();
         Record record;
+        while (it.Next(&record)) {
+            records.push_back(std::move(record));
+        }
+        LOG_INFO("SeqScan completed, total records: " + std::to_string(records.size()));
+        return records;
+    }
+
+    TableIterator HeapFile::Scan(int32_t begin_page_no, int32_t end_page_no) {
+        return TableIterator(this, begin_page_no, end_page_no);
+    }
 
-        // 遍历到目标 slot_id 对应的记录
-        for (int i = 0; i <= rid.slot_id; ++i) {
-            // 读取当前记录的头部
-            memcpy(&header, current, sizeof(RecordHeader));
-            // 检查是否越界（slot_id 超出实际记录数）
-            if (i > page->record_count - 1) {
-                LOG_ERROR("Invalid slot_id: " + std::to_string(rid.slot_id));
-                break;
-            }
-            // 找到目标记录
-            if (i == rid.slot_id) {
-                if (!header.is_deleted) {
-                    record.data = std::string(current + sizeof(RecordHeader), header.record_size);
-                    record.rid = rid;
+    std::vector<Record> HeapFile::ParallelScan(const std::function<bool(const RecordRef&)>& predicate,
+                                               int num_threads, int32_t morsel_pages) {
+        int32_t num_pages;
+        {
+            std::shared_lock<std::shared_mutex> pool_lock(pool_latch_);
+            num_pages = mode_ == StorageMode::MMAP_READ_ONLY ? mmap_file_->GetNumPages() : next_page_id_.load();
+            if (num_threads <= 0) {
+                num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+            if (mode_ == StorageMode::BUFFER_POOL) {
+                num_threads = std::min(num_threads, std::max(1, buffer_pool_->GetMaxFrames() / (2 * SCAN_BATCH_PAGES)));
+            }
+        }
+        morsel_pages = std::max(morsel_pages, 1);
+        int32_t num_morsels = (num_pages + morsel_pages - 1) / morsel_pages;
+        num_threads = std::max(1, std::min(num_threads, num_morsels));
+
+        // 每个工作单元的结果单独存放，最后按单元顺序拼接，结果与单线程扫描的顺序相同
+        std::vector<std::vector<Record>> results(num_morsels);
+        std::atomic<int32_t> next_morsel{0};
+        auto worker = [&]() {
+            for (int32_t morsel = next_morsel++; morsel < num_morsels; morsel = next_morsel++) {
+                int32_t begin = morsel * morsel_pages;
+                TableIterator it = Scan(begin, std::min(num_pages, begin + morsel_pages));
+                RecordRef ref;
+                while (it.NextRef(&ref)) {
+                    if (!predicate || predicate(ref)) {
+                        results[morsel].push_back(ref.ToRecord());
+                    }
                 }
-                break;
             }
-            // 移动到下一个记录
-            current += sizeof(RecordHeader) + header.record_size;
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < num_threads; t++) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers) {
+            thread.join();
         }
 
-        buffer_pool_->UnpinPage(page->page_id, false);
-        return record;
+        size_t total = 0;
+        for (const auto& part : results) {
+            total += part.size();
+        }
+        std::vector<Record> records;
+        records.reserve(total);
+        for (auto& part : results) {
+            std::move(part.begin(), part.end(), std::back_inserter(records));
+        }
+        LOG_INFO("ParallelScan completed with " + std::to_string(num_threads) + " threads, total records: " +
+                 std::to_string(records.size()));
+        return records;
     }
-    bool HeapFile::DeleteRecord(const RID& rid) {
-        Page* page = buffer_pool_->FetchPage(rid.page_id);
-        if (page == nullptr) {
-            LOG_ERROR("DeleteRecord failed: page not found");
+
+    TableIterator::TableIterator(HeapFile* table, int32_t begin_page_no, int32_t end_page_no)
+        : table_(table), pool_lock_(table->pool_latch_) {
+        int32_t num_pages = table_->mode_ == StorageMode::MMAP_READ_ONLY ? table_->mmap_file_->GetNumPages()
+                                                                        : table_->next_page_id_.load();
+        next_page_no_ = std::max(begin_page_no, 0);
+        end_page_no_ = end_page_no < 0 ? num_pages : std::min(end_page_no, num_pages);
+        if (table_->mode_ == StorageMode::MMAP_READ_ONLY) {
+            // 由内核做顺序预读，不需要缓冲池的帧环和预读窗口
+            table_->mmap_file_->Advise(MmapAdvice::SEQUENTIAL);
+            return;
+        }
+        // 顺序扫描只在一个小的帧环中轮换，避免冲刷掉缓冲池中的热页；同时开启预读
+        strategy_ = std::make_unique<BufferAccessStrategy>(*table_->buffer_pool_);
+        strategy_->EnableReadAhead(table_->file_id_, end_page_no_);
+    }
+
+    TableIterator::~TableIterator() {
+        if (page_latch_.owns_lock()) {
+            page_latch_.unlock();
+        }
+        ReleaseBatch();
+    }
+
+    bool TableIterator::Next(Record* record) {
+        std::string_view record_data;
+        if (!Advance(&record_data, &record->rid)) {
             return false;
         }
+        record->data.assign(record_data.data(), record_data.size());
+        // 拷贝完即解闩，调用方处理记录期间其他线程可以修改这一页
+        if (page_latch_.owns_lock()) {
+            page_latch_.unlock();
+        }
+        return true;
+    }
 
-        char* current = page->GetData();
-        RecordHeader header;
+    bool TableIterator::NextRef(RecordRef* ref) {
+        ref->guard_.Drop();
+        if (!Advance(&ref->data_, &ref->rid_)) {
+            *ref = RecordRef();
+            return false;
+        }
+        return true;
+    }
 
-        // 遍历到目标 slot_id 对应的记录
-        for (int i = 0; i <= rid.slot_id; ++i) {
-            memcpy(&header, current, sizeof(RecordHeader));
-            if (i > page->record_count - 1) {
-                LOG_ERROR("Invalid slot_id: " + std::to_string(rid.slot_id));
-                buffer_pool_->UnpinPage(page->page_id, false);
+    bool TableIterator::Advance(std::string_view* record_data, RID* rid) {
+        if (table_->mode_ == StorageMode::MMAP_READ_ONLY) {
+            while (true) {
+                int slot_id = mapped_page_ == nullptr ? -1 : HeapFile::NextSlot(mapped_page_, slot_id_, record_data);
+                if (slot_id >= 0) {
+                    *rid = RID(page_id_, slot_id);
+                    slot_id_ = slot_id + 1;
+                    return true;
+                }
+                if (next_page_no_ >= end_page_no_) {
+                    return false;
+                }
+                mapped_page_ = table_->mmap_file_->GetPage(next_page_no_);
+                page_id_ = MakePageID(table_->file_id_, next_page_no_++);
+                slot_id_ = 0;
+            }
+        }
+        while (true) {
+            if (batch_pos_ >= batch_.size() && !FetchBatch()) {
                 return false;
             }
-            if (i == rid.slot_id) {
-                header.is_deleted = true;
-                memcpy(current, &header, sizeof(RecordHeader)); // 更新头部
-                buffer_pool_->UnpinPage(page->page_id, true); // 标记脏页
-                LOG_INFO("Delete record at RID: " + rid.ToString());
-                return true;
+            Page* page = batch_[batch_pos_];
+            if (page != nullptr) {
+                if (!page_latch_.owns_lock()) {
+                    page_latch_ = std::shared_lock<std::shared_mutex>(page->latch);
+                }
+                int slot_id = HeapFile::NextSlot(page->GetData(), slot_id_, record_data);
+                if (slot_id >= 0) {
+                    *rid = RID(page->page_id, slot_id);
+                    slot_id_ = slot_id + 1;
+                    return true;
+                }
+                page_latch_.unlock();
+                table_->buffer_pool_->UnpinPage(page->page_id, false);
+                batch_[batch_pos_] = nullptr;
             }
-            current += sizeof(RecordHeader) + header.record_size;
+            batch_pos_++;
+            slot_id_ = 0;
         }
+    }
 
-        buffer_pool_->UnpinPage(page->page_id, false);
-        return false;
+    bool TableIterator::FetchBatch() {
+        ReleaseBatch();
+        if (next_page_no_ >= end_page_no_) {
+            return false;
+        }
+        // 连续的页成批获取：每个分区只加一次锁，未命中的页一次读入
+        std::vector<PageID> page_ids;
+        for (int32_t end = std::min(end_page_no_, next_page_no_ + HeapFile::SCAN_BATCH_PAGES); next_page_no_ < end;
+             next_page_no_++) {
+            page_ids.push_back(MakePageID(table_->file_id_, next_page_no_));
+        }
+        batch_ = table_->buffer_pool_->FetchPages(page_ids, strategy_.get());
+        batch_pos_ = 0;
+        slot_id_ = 0;
+        return true;
     }
 
-    std::vector<Record> HeapFile::SeqScan() {
-        std::vector<Record> records;
-        PageID current_page_id = 0;
-
-        while (current_page_id < next_page_id_) {
-            Page* page = buffer_pool_->FetchPage(current_page_id);
-            if (page == nullptr) {
-                current_page_id++;
-                continue;
-            }
-
-            char* current = page->GetData();
-            // 遍历页内所有记录
-            for (int i = 0; i < page->record_count; ++i) {
-                RecordHeader header;
-                memcpy(&header, current, sizeof(RecordHeader));
-                if (!header.is_deleted) {
-                    Record record;
-                    record.data = std::string(current + sizeof(RecordHeader), header.record_size);
-                    record.rid = RID(current_page_id, i);
-                    records.push_back(record);
-                }
-                // 移动到下一个记录
-                current += sizeof(RecordHeader) + header.record_size;
+    void TableIterator::ReleaseBatch() {
+        for (Page* page : batch_) {
+            if (page != nullptr) {
+                table_->buffer_pool_->UnpinPage(page->page_id, false);
             }
+        }
+        batch_.clear();
+    }
 
-            buffer_pool_->UnpinPage(current_page_id, false);
-            current_page_id++;
+    bool HeapFile::SetBufferPool(BufferPool* buffer_pool) {
+        std::unique_lock<std::shared_mutex> lock(pool_latch_);
+        if (buffer_pool == buffer_pool_) {
+            return true;
+        }
+        if (buffer_pool->GetDiskManager() != buffer_pool_->GetDiskManager()) {
+            LOG_ERROR("SetBufferPool failed: table " + file_path_ + " is open in another DiskManager");
+            return false;
+        }
+        if (!buffer_pool->AdoptFile(file_id_, buffer_pool_) ||
+            !buffer_pool->AdoptFile(fsm_->GetFileID(), buffer_pool_)) {
+            return false;
         }
+        buffer_pool_ = buffer_pool;
+        fsm_->SetBufferPool(buffer_pool);
+        LOG_INFO("Table " + file_path_ + " switched to another buffer pool");
+        return true;
+    }
 
-        LOG_INFO("SeqScan completed, total records: " + std::to_string(records.size()));
-        return records;
+    BufferPool* HeapFile::GetBufferPool() {
+        std::shared_lock<std::shared_mutex> lock(pool_latch_);
+        return buffer_pool_;
     }
 
-    Page* HeapFile::GetFreePage(const Record& record) {
-        // 简化实现：直接创建新页，实际需遍历查找已有空闲页
-         for (PageID pid = 0; pid < next_page_id_; pid++) {
-            Page* page = buffer_pool_->FetchPage(pid);
-            if (page == nullptr) continue;
+    int HeapFile::GetFreeSpace(const char* data) {
+        HeapPageHeader page_header = ReadPageHeader(data);
+        return page_header.data_begin - static_cast<int>(sizeof(HeapPageHeader)) -
+               static_cast<int>(sizeof(HeapSlot)) * page_header.slot_count;
+    }
 
-            // 检查页面空闲空间是否足够存储新记录（假设记录大小已知）
-            int required_space = sizeof(RecordHeader) + record.data.size(); // 需传入记录大小
-            if (page->GetFreeSpace() >= required_space) {
-                buffer_pool_->UnpinPage(pid, false); // 暂时不修改，仅检查
-                return page;
+    void HeapFile::CompactPage(char* data) {
+        HeapPageHeader page_header = ReadPageHeader(data);
+        // 按偏移从大到小依次把记录移到数据区末尾，移动的目标总不低于源位置，不会覆盖尚未移动的记录
+        std::vector<int> live;
+        for (int i = 0; i < page_header.slot_count; ++i) {
+            HeapSlot slot = ReadSlotEntry(data, i);
+            if (slot.flags & HEAP_SLOT_DELETED) {
+                slot.offset = 0;
+                slot.length = 0;
+                WriteSlotEntry(data, i, slot);
+            } else {
+                live.push_back(i);
             }
-            buffer_pool_->UnpinPage(pid, false);
         }
+        std::sort(live.begin(), live.end(), [data](int a, int b) {
+            return ReadSlotEntry(data, a).offset > ReadSlotEntry(data, b).offset;
+        });
+        int32_t data_begin = PAGE_DATA_SIZE;
+        for (int i : live) {
+            HeapSlot slot = ReadSlotEntry(data, i);
+            data_begin -= slot.length;
+            memmove(data + data_begin, data + slot.offset, slot.length);
+            slot.offset = static_cast<uint16_t>(data_begin);
+            WriteSlotEntry(data, i, slot);
+        }
+        page_header.data_begin = data_begin;
+        // 末尾的已删除槽直接去掉，槽数组随之缩短，页在记录删光后能恢复全部空间
+        while (page_header.slot_count > 0 &&
+               (ReadSlotEntry(data, page_header.slot_count - 1).flags & HEAP_SLOT_DELETED)) {
+            page_header.slot_count--;
+        }
+        memcpy(data, &page_header, sizeof(HeapPageHeader));
+    }
 
-        // 2. 若没有可用页面，再创建新页
-        Page* new_page = buffer_pool_->FetchPage(next_page_id_);
-        next_page_id_++;
-        return new_page;
+    bool HeapFile::ReadSlot(const char* data, int slot_id, std::string_view* record_data) {
+        HeapPageHeader page_header = ReadPageHeader(data);
+        if (slot_id < 0) {
+            LOG_ERROR("Invalid slot_id: " + std::to_string(slot_id));
+            return false;
+        }
+        if (slot_id >= page_header.slot_count) {
+            return false; //末尾的已删除槽在整理页面时被去掉，与已删除相同
+        }
+        HeapSlot slot = ReadSlotEntry(data, slot_id);
+        if (slot.flags & HEAP_SLOT_DELETED) {
+            return false;
+        }
+        *record_data = std::string_view(data + slot.offset, slot.length);
+        return true;
     }
 
-    int HeapFile::SerializeRecord(const Record& record, char* dest) {
-        // 序列化格式：RecordHeader + 记录数据
-        RecordHeader header{false, static_cast<int32_t>(record.data.size())};
-        memcpy(dest, &header, sizeof(RecordHeader));
-        memcpy(dest + sizeof(RecordHeader), record.data.c_str(), record.data.size());
-        return sizeof(RecordHeader) + record.data.size();
+    int HeapFile::NextSlot(const char* data, int slot_id, std::string_view* record_data) {
+        HeapPageHeader page_header = ReadPageHeader(data);
+        // 遍历槽数组，跳过已删除的记录
+        for (; slot_id < page_header.slot_count; ++slot_id) {
+            HeapSlot slot = ReadSlotEntry(data, slot_id);
+            if (!(slot.flags & HEAP_SLOT_DELETED)) {
+                *record_data = std::string_view(data + slot.offset, slot.length);
+                return slot_id;
+            }
+        }
+        return -1;
     }
 
-}
\ No newline at end of file
+    WritePageGuard HeapFile::GetFreePage(const Record& record) {
+        // 由 FSM 找到空闲空间足够的页，没有时新建一页并立即记入 FSM（插入失败时这一页也不会被遗漏）
+        // FSM 只是提示，以加写闩后页内的实际空闲空间为准：不够时（并发插入抢先用掉了空间，新页也可能被
+        // 别的插入先拿到）放开该页、纠正 FSM 后重新查找，检查与后续插入在同一个写闩内完成
+        int required_space = sizeof(HeapSlot) + record.data.size();
+        while (true) {
+            int32_t page_no = fsm_->FindPage(required_space);
+            if (page_no < 0) {
+                page_no = next_page_id_++;
+                fsm_->Update(page_no, PAGE_DATA_SIZE - static_cast<int>(sizeof(HeapPageHeader)));
+            }
+            WritePageGuard guard = buffer_pool_->FetchPageWrite(MakePageID(file_id_, page_no));
+            if (!guard) {
+                return guard;
+            }
+            int free_space = GetFreeSpace(guard.GetData());
+            if (free_space >= required_space) {
+                return guard;
+            }
+            guard.Drop();
+            fsm_->Update(page_no, free_space);
+        }
+    }
+}
@@ -0,0 +1,464 @@
+#include "lightdb/io_engine.h"
+#include "lightdb/logger.h"
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define LIGHTDB_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define LIGHTDB_HAVE_IO_URING 0
+#endif
+namespace lightdb {
+    bool PreadFull(int fd, char* buffer, size_t length, off_t offset) {
+        size_t total = 0;
+        while (total < length) {
+            ssize_t n = pread(fd, buffer + total, length - total, offset + total);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            if (n == 0) break; //读到文件末尾
+            total += n;
+        }
+        if (total < length) {
+            memset(buffer + total, 0, length - total);
+        }
+        return true;
+    }
+
+    bool PwriteFull(int fd, const char* buffer, size_t length, off_t offset) {
+        size_t total = 0;
+        while (total < length) {
+            ssize_t n = pwrite(fd, buffer + total, length - total, offset + total);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            total += n;
+        }
+        return true;
+    }
+
+    std::unique_ptr<IOEngine> MakeIOEngine(IOEngineType type) {
+        if (type == IOEngineType::IO_URING) {
+            auto engine = std::make_unique<IoUringEngine>();
+            if (engine->IsValid()) {
+                return engine;
+            }
+            LOG_WARN("io_uring is not available, fallback to sync I/O engine");
+        }
+        return std::make_unique<SyncIOEngine>();
+    }
+
+    // ---------------- sync ----------------
+    namespace {
+        // 同一文件上偏移连续、方向相同的一段请求合成一次 preadv/pwritev；未完整读写时返回 false，由调用方逐个重做
+        bool VectoredRun(std::vector<IORequest>& requests, size_t begin, size_t end) {
+            std::vector<iovec> iov(end - begin);
+            size_t total = 0;
+            for (size_t i = begin; i < end; i++) {
+                iov[i - begin] = {requests[i].buffer, requests[i].length};
+                total += requests[i].length;
+            }
+            const IORequest& first = requests[begin];
+            ssize_t n;
+            do {
+                n = first.is_write ? pwritev(first.fd, iov.data(), static_cast<int>(iov.size()), first.offset)
+                                   : preadv(first.fd, iov.data(), static_cast<int>(iov.size()), first.offset);
+            } while (n < 0 && errno == EINTR);
+            return n >= 0 && static_cast<size_t>(n) == total;
+        }
+    }
+
+    void SyncIOEngine::Submit(std::vector<IORequest>& requests) {
+        for (size_t begin = 0; begin < requests.size();) {
+            const IORequest& first = requests[begin];
+            size_t end = begin + 1;
+            while (end < requests.size() && end - begin < IOV_MAX && requests[end].is_write == first.is_write &&
+                   requests[end].fd == first.fd &&
+                   requests[end].offset == requests[end - 1].offset + static_cast<off_t>(requests[end - 1].length)) {
+                end++;
+            }
+            if (end - begin > 1 && VectoredRun(requests, begin, end)) {
+                for (size_t i = begin; i < end; i++) {
+                    if (requests[i].callback) {
+                        requests[i].callback(true);
+                    }
+                }
+                begin = end;
+                continue;
+            }
+            for (; begin < end; begin++) {
+                SubmitOne(requests[begin]);
+            }
+        }
+    }
+
+    void SyncIOEngine::SubmitOne(IORequest& req) {
+        bool ok = req.is_write ? PwriteFull(req.fd, req.buffer, req.length, req.offset)
+                               : PreadFull(req.fd, req.buffer, req.length, req.offset);
+        if (!ok) {
+            LOG_ERROR(std::string(req.is_write ? "pwrite" : "pread") + " failed: " + std::strerror(errno));
+        }
+        if (req.callback) {
+            req.callback(ok);
+        }
+    }
+
+    // ---------------- io_uring ----------------
+#if LIGHTDB_HAVE_IO_URING
+    namespace {
+        // 单个注册缓冲区的上限为 1GB，更大的区域拆成多段注册
+        const size_t MAX_FIXED_BUFFER_SIZE = 1ul << 30;
+        const uint64_t NOP_USER_DATA = 0;
+
+        // 在途请求的上下文，地址作为 SQE 的 user_data
+        struct InFlight {
+            IORequest request;
+        };
+
+        int SysSetup(unsigned entries, io_uring_params* params) {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int SysEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        int SysRegister(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+            return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+        }
+
+        // io_uring_enter 返回 EAGAIN/EBUSY（内核资源暂缺或完成队列积压）时稍候再试，每次加倍，最长 1ms；
+        // 调用方持有 submit_mutex_，不能在这里收割（ReapCompletions 也要获取它），完成线程会继续收割
+        void BackOff(int* delay_us) {
+            std::this_thread::sleep_for(std::chrono::microseconds(*delay_us));
+            *delay_us = std::min(*delay_us * 2, 1000);
+        }
+
+        // 完成 I/O 的剩余部分（短读/短写或内核返回可重试错误时）
+        bool FinishSync(const IORequest& req, size_t done) {
+            return req.is_write ? PwriteFull(req.fd, req.buffer + done, req.length - done, req.offset + done)
+                                : PreadFull(req.fd, req.buffer + done, req.length - done, req.offset + done);
+        }
+    }
+
+    IoUringEngine::IoUringEngine(unsigned queue_depth) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        int fd = SysSetup(queue_depth, &params);
+        if (fd < 0) {
+            LOG_WARN(std::string("io_uring_setup failed: ") + std::strerror(errno));
+            return;
+        }
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+        sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) {
+            sq_ring_ = nullptr;
+        } else if (single_mmap) {
+            cq_ring_ = sq_ring_;
+        } else {
+            cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED) cq_ring_ = nullptr;
+        }
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes_ == MAP_FAILED) sqes_ = nullptr;
+        if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr) {
+            LOG_WARN(std::string("io_uring mmap failed: ") + std::strerror(errno));
+            if (sqes_ != nullptr) munmap(sqes_, sqes_size_);
+            if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+            if (sq_ring_ != nullptr) munmap(sq_ring_, sq_ring_size_);
+            sq_ring_ = cq_ring_ = sqes_ = nullptr;
+            close(fd);
+            return;
+        }
+        char* sq = static_cast<char*>(sq_ring_);
+        char* cq = static_cast<char*>(cq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = cq + params.cq_off.cqes;
+        // SQE 与 array 槽位一一对应，填充一次即可
+        for (unsigned i = 0; i < params.sq_entries; i++) {
+            sq_array_[i] = i;
+        }
+        sq_entries_ = params.sq_entries;
+        ring_fd_ = fd;
+        completion_thread_ = std::thread(&IoUringEngine::CompletionLoop, this);
+        LOG_INFO("io_uring engine started, queue depth " + std::to_string(sq_entries_));
+    }
+
+    IoUringEngine::~IoUringEngine() {
+        if (ring_fd_ < 0) {
+            return;
+        }
+        // 完成线程在收割完所有在途请求后退出
+        stopping_ = true;
+        SubmitNop();
+        completion_thread_.join();
+        if (!regions_.empty()) {
+            SysRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        }
+        munmap(sqes_, sqes_size_);
+        if (cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+        munmap(sq_ring_, sq_ring_size_);
+        close(ring_fd_);
+    }
+
+    int IoUringEngine::FindRegion(const char* buffer, size_t length) const {
+        for (size_t i = 0; i < regions_.size(); i++) {
+            if (buffer >= regions_[i].base && buffer + length <= regions_[i].base + regions_[i].length) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void IoUringEngine::RegisterBufferRegion(void* base, size_t length) {
+        std::unique_lock<std::mutex> lock(submit_mutex_);
+        // 重新注册会替换整张缓冲区表，需等在途的固定缓冲区请求全部完成
+        slots_available_.wait(lock, [this]() { return in_flight_ == 0; });
+        std::vector<Region> regions = regions_;
+        char* p = static_cast<char*>(base);
+        for (size_t off = 0; off < length; off += MAX_FIXED_BUFFER_SIZE) {
+            regions.push_back({p + off, std::min(MAX_FIXED_BUFFER_SIZE, length - off)});
+        }
+        UpdateRegions(std::move(regions));
+    }
+
+    void IoUringEngine::UnregisterBufferRegion(void* base, size_t length) {
+        std::unique_lock<std::mutex> lock(submit_mutex_);
+        slots_available_.wait(lock, [this]() { return in_flight_ == 0; });
+        char* begin = static_cast<char*>(base);
+        std::vector<Region> regions;
+        for (const auto& region : regions_) {
+            if (region.base < begin || region.base >= begin + length) {
+                regions.push_back(region);
+            }
+        }
+        if (regions.size() != regions_.size()) {
+            UpdateRegions(std::move(regions));
+        }
+    }
+
+    void IoUringEngine::UpdateRegions(std::vector<Region> regions) {
+        auto to_iovecs = [](const std::vector<Region>& list) {
+            std::vector<iovec> iovecs;
+            for (const auto& region : list) {
+                iovecs.push_back({region.base, region.length});
+            }
+            return iovecs;
+        };
+        if (!regions_.empty()) {
+            SysRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        }
+        std::vector<iovec> iovecs = to_iovecs(regions);
+        if (regions.empty() || SysRegister(ring_fd_, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) == 0) {
+            regions_ = std::move(regions);
+            return;
+        }
+        // 常见原因是超出 RLIMIT_MEMLOCK：不使用固定缓冲区，I/O 仍可正常进行；尽量保留原有的注册
+        LOG_WARN(std::string("io_uring register buffers failed: ") + std::strerror(errno));
+        std::vector<iovec> old = to_iovecs(regions_);
+        if (!old.empty() && SysRegister(ring_fd_, IORING_REGISTER_BUFFERS, old.data(), old.size()) != 0) {
+            regions_.clear();
+        }
+    }
+
+    void IoUringEngine::Submit(std::vector<IORequest>& requests) {
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(sqes_);
+        std::unique_lock<std::mutex> lock(submit_mutex_);
+        size_t next = 0;
+        std::vector<InFlight*> chunk;
+        std::vector<std::unique_ptr<InFlight>> failed; //未能提交的请求，释放锁后以失败回调
+        while (next < requests.size()) {
+            // 在途请求数不超过提交队列长度，完成队列（至少两倍长）不会溢出
+            slots_available_.wait(lock, [this]() { return in_flight_ < sq_entries_; });
+            unsigned mask = *sq_mask_;
+            unsigned tail = *sq_tail_;
+            unsigned count = 0;
+            chunk.clear();
+            for (; next < requests.size() && in_flight_ < sq_entries_; next++) {
+                IORequest& req = requests[next];
+                io_uring_sqe* sqe = &sqes[tail & mask];
+                memset(sqe, 0, sizeof(*sqe));
+                int region = FindRegion(req.buffer, req.length);
+                if (region >= 0) {
+                    sqe->opcode = req.is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+                    sqe->buf_index = static_cast<uint16_t>(region);
+                } else {
+                    sqe->opcode = req.is_write ? IORING_OP_WRITE : IORING_OP_READ;
+                }
+                sqe->fd = req.fd;
+                sqe->off = static_cast<uint64_t>(req.offset);
+                sqe->addr = reinterpret_cast<uint64_t>(req.buffer);
+                sqe->len = static_cast<uint32_t>(req.length);
+                chunk.push_back(new InFlight{std::move(req)});
+                sqe->user_data = reinterpret_cast<uint64_t>(chunk.back());
+                tail++;
+                count++;
+                in_flight_++;
+            }
+            __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+            // 整批请求只需一次系统调用
+            unsigned submitted = 0;
+            int delay_us = 1;
+            while (submitted < count) {
+                int ret = SysEnter(ring_fd_, count - submitted, 0, 0);
+                if (ret >= 0) {
+                    submitted += ret;
+                } else if (errno == EAGAIN || errno == EBUSY) {
+                    BackOff(&delay_us);
+                } else if (errno != EINTR) {
+                    break;
+                }
+            }
+            if (submitted < count) {
+                // 内核按顺序消费 SQE，未提交的是本批末尾的 count - submitted 个：收回这些槽位，
+                // 连同之后尚未入队的请求一起以失败结束，否则等待它们完成的调用方会永远等下去
+                LOG_ERROR(std::string("io_uring_enter failed: ") + std::strerror(errno));
+                unsigned unsubmitted = count - submitted;
+                __atomic_store_n(sq_tail_, tail - unsubmitted, __ATOMIC_RELEASE);
+                in_flight_ -= unsubmitted;
+                for (unsigned i = submitted; i < count; i++) {
+                    failed.emplace_back(chunk[i]);
+                }
+                break;
+            }
+        }
+        lock.unlock();
+        if (!failed.empty()) {
+            slots_available_.notify_all();
+            for (auto& op : failed) {
+                if (op->request.callback) {
+                    op->request.callback(false);
+                }
+            }
+            for (; next < requests.size(); next++) {
+                if (requests[next].callback) {
+                    requests[next].callback(false);
+                }
+            }
+        }
+        // 命中页缓存的读在提交时往往已经完成，提交方顺手收割，省去完成线程的一次唤醒与切换
+        if (reap_mutex_.try_lock()) {
+            ReapCompletions();
+            reap_mutex_.unlock();
+        }
+    }
+
+    void IoUringEngine::SubmitNop() {
+        std::unique_lock<std::mutex> lock(submit_mutex_);
+        slots_available_.wait(lock, [this]() { return in_flight_ < sq_entries_; });
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(sqes_);
+        unsigned tail = *sq_tail_;
+        io_uring_sqe* sqe = &sqes[tail & *sq_mask_];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = NOP_USER_DATA;
+        in_flight_++;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        int delay_us = 1;
+        while (SysEnter(ring_fd_, 1, 0, 0) < 0) {
+            if (errno == EAGAIN || errno == EBUSY) {
+                BackOff(&delay_us);
+            } else if (errno != EINTR) {
+                // 收回槽位，否则等待在途请求归零的完成线程无法退出
+                LOG_ERROR(std::string("io_uring_enter failed: ") + std::strerror(errno));
+                __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+                in_flight_--;
+                lock.unlock();
+                slots_available_.notify_all();
+                return;
+            }
+        }
+    }
+
+    unsigned IoUringEngine::ReapCompletions() {
+        io_uring_cqe* cqes = static_cast<io_uring_cqe*>(cqes_);
+        unsigned mask = *cq_mask_;
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned reaped = 0;
+        for (; head != tail; head++, reaped++) {
+            uint64_t user_data = cqes[head & mask].user_data;
+            int res = cqes[head & mask].res;
+            // 先归还 CQE 槽位再执行回调
+            __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+            if (user_data == NOP_USER_DATA) {
+                continue;
+            }
+            std::unique_ptr<InFlight> op(reinterpret_cast<InFlight*>(user_data));
+            const IORequest& req = op->request;
+            bool ok;
+            if (res >= 0) {
+                // 短读（文件末尾）补零，短写补写剩余部分
+                ok = static_cast<size_t>(res) == req.length || FinishSync(req, res);
+            } else if (res == -EAGAIN || res == -EINTR) {
+                ok = FinishSync(req, 0);
+            } else {
+                LOG_ERROR(std::string("io_uring ") + (req.is_write ? "write" : "read") + " failed: " +
+                          std::strerror(-res));
+                ok = false;
+            }
+            if (req.callback) {
+                req.callback(ok);
+            }
+        }
+        if (reaped > 0) {
+            {
+                std::lock_guard<std::mutex> lock(submit_mutex_);
+                in_flight_ -= reaped;
+            }
+            slots_available_.notify_all();
+        }
+        return reaped;
+    }
+
+    void IoUringEngine::CompletionLoop() {
+        while (true) {
+            unsigned reaped;
+            {
+                std::lock_guard<std::mutex> lock(reap_mutex_);
+                reaped = ReapCompletions();
+            }
+            {
+                std::lock_guard<std::mutex> lock(submit_mutex_);
+                if (stopping_ && in_flight_ == 0) {
+                    break;
+                }
+            }
+            if (reaped == 0) {
+                SysEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+            }
+        }
+    }
+#else
+    IoUringEngine::IoUringEngine(unsigned /*queue_depth*/) {}
+    IoUringEngine::~IoUringEngine() {}
+    int IoUringEngine::FindRegion(const char* /*buffer*/, size_t /*length*/) const { return -1; }
+    void IoUringEngine::RegisterBufferRegion(void* /*base*/, size_t /*length*/) {}
+    void IoUringEngine::UnregisterBufferRegion(void* /*base*/, size_t /*length*/) {}
+    void IoUringEngine::UpdateRegions(std::vector<Region> /*regions*/) {}
+    void IoUringEngine::Submit(std::vector<IORequest>& /*requests*/) {}
+    void IoUringEngine::SubmitNop() {}
+    unsigned IoUringEngine::ReapCompletions() { return 0; }
+    void IoUringEngine::CompletionLoop() {}
+#endif
+}
@@ -0,0 +1,121 @@
+#include "lightdb/memory_arena.h"
+#include "lightdb/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+namespace lightdb {
+    namespace {
+        size_t RoundUp(size_t length, size_t unit) {
+            return (length + unit - 1) / unit * unit;
+        }
+    }
+
+    MemoryArena::MemoryArena(size_t length, HugePageMode mode, bool prefault) : length_(length) {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+        if (mode == HugePageMode::EXPLICIT) {
+            // 大页池不足（vm.nr_hugepages 未预留）时 mmap 直接失败，退回透明大页
+            size_t mapped = RoundUp(length, HUGE_PAGE_SIZE);
+            void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | (prefault ? MAP_POPULATE : 0), -1, 0);
+            if (p != MAP_FAILED) {
+                base_ = static_cast<char*>(p);
+                mapped_length_ = mapped;
+                backing_ = HugePageMode::EXPLICIT;
+                LOG_INFO("Memory arena of " + std::to_string(mapped) + " bytes backed by " + BackingName());
+                return;
+            }
+            LOG_WARN(std::string("MAP_HUGETLB failed, fall back to transparent huge pages: ") + std::strerror(errno));
+            mode = HugePageMode::TRANSPARENT;
+        }
+#endif
+        // 透明大页只作用于 2MB 对齐的区间：多映射 2MB，再裁掉首尾使起始地址对齐
+        size_t mapped = RoundUp(length, mode == HugePageMode::NONE ? 4096 : HUGE_PAGE_SIZE);
+        size_t reserve = mode == HugePageMode::NONE ? mapped : mapped + HUGE_PAGE_SIZE;
+        void* p = mmap(nullptr, reserve, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p == MAP_FAILED) {
+            LOG_ERROR(std::string("Memory arena mmap failed: ") + std::strerror(errno));
+            throw std::bad_alloc();
+        }
+        char* start = static_cast<char*>(p);
+        if (reserve != mapped) {
+            char* aligned = reinterpret_cast<char*>(RoundUp(reinterpret_cast<uintptr_t>(start), HUGE_PAGE_SIZE));
+            if (aligned != start) {
+                munmap(start, aligned - start);
+            }
+            size_t tail = (start + reserve) - (aligned + mapped);
+            if (tail > 0) {
+                munmap(aligned + mapped, tail);
+            }
+            start = aligned;
+        }
+        base_ = start;
+        mapped_length_ = mapped;
+#ifdef MADV_HUGEPAGE
+        if (mode == HugePageMode::TRANSPARENT) {
+            // 透明大页被系统禁用（transparent_hugepage=never）时 madvise 失败，继续使用普通页
+            if (madvise(base_, mapped_length_, MADV_HUGEPAGE) == 0) {
+                backing_ = HugePageMode::TRANSPARENT;
+            } else {
+                LOG_WARN(std::string("MADV_HUGEPAGE failed, use normal pages: ") + std::strerror(errno));
+            }
+        }
+#endif
+        if (prefault) {
+            Populate(0, mapped_length_);
+        }
+        LOG_INFO("Memory arena of " + std::to_string(mapped_length_) + " bytes backed by " + BackingName());
+    }
+
+    MemoryArena::~MemoryArena() {
+        if (base_ != nullptr) {
+            munmap(base_, mapped_length_);
+        }
+    }
+
+    const char* MemoryArena::BackingName() const {
+        switch (backing_) {
+            case HugePageMode::EXPLICIT: return "hugetlb";
+            case HugePageMode::TRANSPARENT: return "transparent huge pages";
+            default: return "normal pages";
+        }
+    }
+
+    void MemoryArena::Populate(size_t offset, size_t length) {
+        if (offset >= mapped_length_) {
+            return;
+        }
+        length = std::min(length, mapped_length_ - offset);
+#ifdef MADV_POPULATE_WRITE
+        // Linux 5.14+：一次系统调用分配并映射所有页
+        if (madvise(base_ + offset, length, MADV_POPULATE_WRITE) == 0) {
+            return;
+        }
+#endif
+        // 逐页写一个字节触发缺页；透明大页下每个 2MB 区间的首次写入即分配整个大页
+        volatile char* p = base_ + offset;
+        for (size_t off = 0; off < length; off += 4096) {
+            p[off] = 0;
+        }
+    }
+
+    void MemoryArena::Discard(size_t offset, size_t length) {
+        if (offset >= mapped_length_) {
+            return;
+        }
+        size_t end = std::min(offset + length, mapped_length_);
+        if (backing_ == HugePageMode::EXPLICIT) {
+            // hugetlb 映射只能按整个大页归还
+            offset = RoundUp(offset, HUGE_PAGE_SIZE);
+            end = end / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        }
+        if (offset >= end) {
+            return;
+        }
+        if (madvise(base_ + offset, end - offset, MADV_DONTNEED) != 0) {
+            LOG_WARN(std::string("madvise(MADV_DONTNEED) failed: ") + std::strerror(errno));
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include "lightdb/mmap_file.h"
+#include "lightdb/logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+namespace lightdb {
+    MmapFile::MmapFile(const std::string& file_path) {
+        int fd = open(file_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            LOG_ERROR("Open file " + file_path + " for mmap failed: " + std::strerror(errno));
+            num_pages_ = -1;
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            LOG_ERROR("Stat file " + file_path + " failed: " + std::strerror(errno));
+            close(fd);
+            num_pages_ = -1;
+            return;
+        }
+        // 末尾不足一页的部分不映射；空文件没有可映射的内容
+        num_pages_ = static_cast<int32_t>(st.st_size / PAGE_SIZE);
+        length_ = static_cast<size_t>(num_pages_) * PAGE_SIZE;
+        if (length_ > 0) {
+            void* p = mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                LOG_ERROR("mmap file " + file_path + " failed: " + std::strerror(errno));
+                num_pages_ = -1;
+                length_ = 0;
+            } else {
+                base_ = static_cast<const char*>(p);
+            }
+        }
+        // 映射建立后即可关闭文件描述符
+        close(fd);
+        LOG_INFO("Mapped file " + file_path + " with " + std::to_string(num_pages_) + " pages");
+    }
+
+    MmapFile::~MmapFile() {
+        if (base_ != nullptr) {
+            munmap(const_cast<char*>(base_), length_);
+        }
+    }
+
+    void MmapFile::Advise(MmapAdvice advice) const {
+        if (base_ == nullptr) {
+            return;
+        }
+        int flag = MADV_NORMAL;
+        if (advice == MmapAdvice::SEQUENTIAL) {
+            flag = MADV_SEQUENTIAL;
+        } else if (advice == MmapAdvice::RANDOM) {
+            flag = MADV_RANDOM;
+        }
+        if (madvise(const_cast<char*>(base_), length_, flag) != 0) {
+            LOG_WARN(std::string("madvise failed: ") + std::strerror(errno));
+        }
+    }
+}
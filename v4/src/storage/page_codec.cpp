@@ -0,0 +1,138 @@
+#include "lightdb/page_codec.h"
+#include <cstdint>
+#include <cstring>
+namespace lightdb {
+    // 编码由若干序列组成，每个序列：
+    //   token(1 字节，高 4 位为字面量长度，低 4 位为匹配长度 - MIN_MATCH，取 15 时后续追加 255 进制的扩展字节)
+    //   字面量长度扩展、字面量、匹配偏移(2 字节小端)、匹配长度扩展
+    // 最后一个序列只有字面量，解码读完字面量恰好到达输入末尾即结束
+    namespace {
+        const int MIN_MATCH = 4;
+        const int HASH_BITS = 12;
+        const int MAX_OFFSET = 65535;
+
+        uint32_t Load32(const char* p) {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint32_t Hash(uint32_t seq) {
+            return (seq * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        // 写入 15 之后的扩展长度
+        bool PutLength(int length, char* dst, int& op, int capacity) {
+            while (length >= 255) {
+                if (op >= capacity) return false;
+                dst[op++] = static_cast<char>(255);
+                length -= 255;
+            }
+            if (op >= capacity) return false;
+            dst[op++] = static_cast<char>(length);
+            return true;
+        }
+
+        // 输出一个序列；match_length 为 0 表示最后一个只含字面量的序列
+        bool EmitSequence(const char* literals, int literal_length, int offset, int match_length, char* dst, int& op,
+                          int capacity) {
+            if (op >= capacity) return false;
+            int token_pos = op++;
+            int lit_nibble = literal_length < 15 ? literal_length : 15;
+            int match_code = match_length > 0 ? match_length - MIN_MATCH : 0;
+            int match_nibble = match_code < 15 ? match_code : 15;
+            dst[token_pos] = static_cast<char>((lit_nibble << 4) | match_nibble);
+            if (lit_nibble == 15 && !PutLength(literal_length - 15, dst, op, capacity)) return false;
+            if (op + literal_length > capacity) return false;
+            memcpy(dst + op, literals, literal_length);
+            op += literal_length;
+            if (match_length == 0) return true;
+            if (op + 2 > capacity) return false;
+            dst[op++] = static_cast<char>(offset & 0xFF);
+            dst[op++] = static_cast<char>(offset >> 8);
+            if (match_nibble == 15 && !PutLength(match_code - 15, dst, op, capacity)) return false;
+            return true;
+        }
+
+        // 读取扩展长度，输入不足时返回 false
+        bool GetLength(const unsigned char* src, int src_len, int& ip, int& length) {
+            unsigned char b;
+            do {
+                if (ip >= src_len) return false;
+                b = src[ip++];
+                length += b;
+            } while (b == 255);
+            return true;
+        }
+    }
+
+    int LzCompress(const char* src, int src_len, char* dst, int dst_capacity) {
+        int table[1 << HASH_BITS];
+        for (int& pos : table) {
+            pos = -1;
+        }
+        int op = 0;
+        int anchor = 0;
+        int ip = 0;
+        while (ip + MIN_MATCH <= src_len) {
+            uint32_t seq = Load32(src + ip);
+            uint32_t h = Hash(seq);
+            int ref = table[h];
+            table[h] = ip;
+            if (ref < 0 || ip - ref > MAX_OFFSET || Load32(src + ref) != seq) {
+                ip++;
+                continue;
+            }
+            int length = MIN_MATCH;
+            while (ip + length < src_len && src[ref + length] == src[ip + length]) {
+                length++;
+            }
+            if (!EmitSequence(src + anchor, ip - anchor, ip - ref, length, dst, op, dst_capacity)) {
+                return 0;
+            }
+            ip += length;
+            anchor = ip;
+            // 匹配末尾的位置也登记进哈希表，提高下一段的命中率
+            if (ip + MIN_MATCH <= src_len && ip >= 2) {
+                table[Hash(Load32(src + ip - 2))] = ip - 2;
+            }
+        }
+        if (!EmitSequence(src + anchor, src_len - anchor, 0, 0, dst, op, dst_capacity)) {
+            return 0;
+        }
+        return op;
+    }
+
+    int LzDecompress(const char* src, int src_len, char* dst, int dst_capacity) {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+        int ip = 0;
+        int op = 0;
+        while (ip < src_len) {
+            int token = in[ip++];
+            int literal_length = token >> 4;
+            if (literal_length == 15 && !GetLength(in, src_len, ip, literal_length)) return -1;
+            if (literal_length > src_len - ip || literal_length > dst_capacity - op) return -1;
+            memcpy(dst + op, src + ip, literal_length);
+            ip += literal_length;
+            op += literal_length;
+            if (ip == src_len) {
+                break; //最后一个序列
+            }
+            if (src_len - ip < 2) return -1;
+            int offset = in[ip] | (in[ip + 1] << 8);
+            ip += 2;
+            if (offset == 0 || offset > op) return -1;
+            int match_length = token & 15;
+            if (match_length == 15 && !GetLength(in, src_len, ip, match_length)) return -1;
+            match_length += MIN_MATCH;
+            if (match_length > dst_capacity - op) return -1;
+            // 匹配可以与输出重叠（offset < match_length 时重复前面的字节），逐字节复制
+            const char* match = dst + op - offset;
+            for (int i = 0; i < match_length; i++) {
+                dst[op + i] = match[i];
+            }
+            op += match_length;
+        }
+        return op;
+    }
+}
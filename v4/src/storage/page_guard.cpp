@@ -0,0 +1,62 @@
+#include "lightdb/page_guard.h"
+#include "lightdb/buffer_pool.h"
+#include <utility>
+namespace lightdb {
+    // ---------------- ReadPageGuard ----------------
+    ReadPageGuard::ReadPageGuard(BufferPool* buffer_pool, Page* page)
+        : buffer_pool_(buffer_pool), page_(page) {}
+
+    ReadPageGuard::ReadPageGuard(ReadPageGuard&& other) noexcept
+        : buffer_pool_(std::exchange(other.buffer_pool_, nullptr)), page_(std::exchange(other.page_, nullptr)) {}
+
+    ReadPageGuard& ReadPageGuard::operator=(ReadPageGuard&& other) noexcept {
+        if (this != &other) {
+            Drop();
+            buffer_pool_ = std::exchange(other.buffer_pool_, nullptr);
+            page_ = std::exchange(other.page_, nullptr);
+        }
+        return *this;
+    }
+
+    void ReadPageGuard::Drop() {
+        if (page_ == nullptr) {
+            return;
+        }
+        // 先解闩再 unpin：unpin 后帧可能被淘汰并分配给其他页
+        PageID page_id = page_->page_id;
+        page_->latch.unlock_shared();
+        buffer_pool_->UnpinPage(page_id, false);
+        page_ = nullptr;
+        buffer_pool_ = nullptr;
+    }
+
+    // ---------------- WritePageGuard ----------------
+    WritePageGuard::WritePageGuard(BufferPool* buffer_pool, Page* page)
+        : buffer_pool_(buffer_pool), page_(page) {}
+
+    WritePageGuard::WritePageGuard(WritePageGuard&& other) noexcept
+        : buffer_pool_(std::exchange(other.buffer_pool_, nullptr)), page_(std::exchange(other.page_, nullptr)),
+          is_dirty_(std::exchange(other.is_dirty_, false)) {}
+
+    WritePageGuard& WritePageGuard::operator=(WritePageGuard&& other) noexcept {
+        if (this != &other) {
+            Drop();
+            buffer_pool_ = std::exchange(other.buffer_pool_, nullptr);
+            page_ = std::exchange(other.page_, nullptr);
+            is_dirty_ = std::exchange(other.is_dirty_, false);
+        }
+        return *this;
+    }
+
+    void WritePageGuard::Drop() {
+        if (page_ == nullptr) {
+            return;
+        }
+        PageID page_id = page_->page_id;
+        page_->latch.unlock();
+        buffer_pool_->UnpinPage(page_id, is_dirty_);
+        page_ = nullptr;
+        buffer_pool_ = nullptr;
+        is_dirty_ = false;
+    }
+}
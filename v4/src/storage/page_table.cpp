@@ -0,0 +1,98 @@
+#include "lightdb/page_table.h"
+namespace lightdb {
+    namespace {
+        const uint64_t EMPTY_SLOT = ~0ull; //PageID 与帧下标均为 -1
+    }
+
+    PageTable::PageTable(size_t max_entries) : size_(0) {
+        // 装载因子不超过 0.5，保证探测链足够短
+        size_t capacity = 16;
+        int bits = 4;
+        while (capacity < max_entries * 2) {
+            capacity <<= 1;
+            bits++;
+        }
+        slots_.reset(new std::atomic<uint64_t>[capacity]);
+        for (size_t i = 0; i < capacity; i++) {
+            slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+        }
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        hash_shift_ = 64 - bits;
+    }
+
+    size_t PageTable::Hash(PageID page_id) const {
+        // Fibonacci 哈希：同一文件内连续页号也能均匀散开
+        uint64_t key = static_cast<uint32_t>(page_id);
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> hash_shift_);
+    }
+
+    bool PageTable::Find(PageID page_id, frame_id_t* frame_id) const {
+        // 空槽解码出的页号正是 INVALID_PAGE_ID，不能拿它去匹配
+        if (page_id == INVALID_PAGE_ID) {
+            return false;
+        }
+        // 表中至少一半槽位为空，探测最多一整圈（并发修改下作为兜底）
+        size_t pos = Hash(page_id);
+        for (size_t probes = 0; probes < capacity_; probes++, pos = (pos + 1) & mask_) {
+            uint64_t slot = slots_[pos].load(std::memory_order_acquire);
+            if (slot == EMPTY_SLOT) {
+                return false;
+            }
+            if (SlotPage(slot) == page_id) {
+                *frame_id = SlotFrame(slot);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PageTable::Insert(PageID page_id, frame_id_t frame_id) {
+        if (page_id == INVALID_PAGE_ID || size_ + 1 > capacity_ / 2) {
+            return false;
+        }
+        for (size_t pos = Hash(page_id); ; pos = (pos + 1) & mask_) {
+            uint64_t slot = slots_[pos].load(std::memory_order_relaxed);
+            if (SlotPage(slot) == page_id) {
+                return false;
+            }
+            if (slot == EMPTY_SLOT) {
+                slots_[pos].store(Pack(page_id, frame_id), std::memory_order_release);
+                size_++;
+                return true;
+            }
+        }
+    }
+
+    bool PageTable::Erase(PageID page_id) {
+        // 否则会把空槽当作要删除的元素，在探测链上打出空洞
+        if (page_id == INVALID_PAGE_ID) {
+            return false;
+        }
+        size_t pos = Hash(page_id);
+        while (SlotPage(slots_[pos].load(std::memory_order_relaxed)) != page_id) {
+            if (slots_[pos].load(std::memory_order_relaxed) == EMPTY_SLOT) {
+                return false;
+            }
+            pos = (pos + 1) & mask_;
+        }
+        // 向后移位删除：把后续探测链上的元素前移，避免留下墓碑
+        size_t hole = pos;
+        for (size_t next = (hole + 1) & mask_; ; next = (next + 1) & mask_) {
+            uint64_t slot = slots_[next].load(std::memory_order_relaxed);
+            if (slot == EMPTY_SLOT) {
+                break;
+            }
+            size_t home = Hash(SlotPage(slot));
+            // home 落在 (hole, next] 循环区间内时不能移动，否则会断开它自己的探测链
+            bool in_range = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+            if (!in_range) {
+                slots_[hole].store(slot, std::memory_order_release);
+                hole = next;
+            }
+        }
+        slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+        size_--;
+        return true;
+    }
+}
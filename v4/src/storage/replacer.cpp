@@ -0,0 +1,566 @@
+#include "lightdb/replacer.h"
+#include <algorithm>
+namespace lightdb {
+    std::unique_ptr<Replacer> MakeReplacer(ReplacerType type, size_t num_frames) {
+        switch (type) {
+            case ReplacerType::CLOCK:
+                return std::make_unique<ClockReplacer>(num_frames);
+            case ReplacerType::CLOCK_PRO:
+                return std::make_unique<ClockProReplacer>(num_frames);
+            case ReplacerType::TWO_Q:
+                return std::make_unique<TwoQueueReplacer>(num_frames);
+            case ReplacerType::LRU:
+            default:
+                return std::make_unique<LRUReplacer>(num_frames);
+        }
+    }
+
+    // ---------------- LRU ----------------
+    LRUReplacer::LRUReplacer(size_t num_frames)
+        : prev_(num_frames, INVALID_FRAME_ID), next_(num_frames, INVALID_FRAME_ID), in_list_(num_frames, false) {}
+
+    void LRUReplacer::PushFront(frame_id_t frame_id) {
+        prev_[frame_id] = INVALID_FRAME_ID;
+        next_[frame_id] = head_;
+        if (head_ != INVALID_FRAME_ID) {
+            prev_[head_] = frame_id;
+        }
+        head_ = frame_id;
+        if (tail_ == INVALID_FRAME_ID) {
+            tail_ = frame_id;
+        }
+        in_list_[frame_id] = true;
+    }
+
+    void LRUReplacer::PushBack(frame_id_t frame_id) {
+        prev_[frame_id] = tail_;
+        next_[frame_id] = INVALID_FRAME_ID;
+        if (tail_ != INVALID_FRAME_ID) {
+            next_[tail_] = frame_id;
+        }
+        tail_ = frame_id;
+        if (head_ == INVALID_FRAME_ID) {
+            head_ = frame_id;
+        }
+        in_list_[frame_id] = true;
+    }
+
+    void LRUReplacer::Unlink(frame_id_t frame_id) {
+        if (prev_[frame_id] != INVALID_FRAME_ID) {
+            next_[prev_[frame_id]] = next_[frame_id];
+        } else {
+            head_ = next_[frame_id];
+        }
+        if (next_[frame_id] != INVALID_FRAME_ID) {
+            prev_[next_[frame_id]] = prev_[frame_id];
+        } else {
+            tail_ = prev_[frame_id];
+        }
+        prev_[frame_id] = next_[frame_id] = INVALID_FRAME_ID;
+        in_list_[frame_id] = false;
+    }
+
+    void LRUReplacer::RecordLoad(frame_id_t frame_id, PageID /*page_id*/, AccessType type) {
+        if (in_list_[frame_id]) {
+            Unlink(frame_id);
+        }
+        if (type == AccessType::SEQUENTIAL) {
+            PushBack(frame_id);
+        } else {
+            PushFront(frame_id);
+        }
+    }
+
+    void LRUReplacer::RecordAccess(frame_id_t frame_id, AccessType type) {
+        // 移除旧位置，插入到头部
+        if (type == AccessType::NORMAL && in_list_[frame_id] && head_ != frame_id) {
+            Unlink(frame_id);
+            PushFront(frame_id);
+        }
+    }
+
+    bool LRUReplacer::Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) {
+        // 从链表尾部（最久未使用）向前找第一个可淘汰的帧
+        for (frame_id_t fid = tail_; fid != INVALID_FRAME_ID; fid = prev_[fid]) {
+            if (is_evictable(fid)) {
+                Unlink(fid);
+                *victim = fid;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void LRUReplacer::Remove(frame_id_t frame_id) {
+        if (in_list_[frame_id]) {
+            Unlink(frame_id);
+        }
+    }
+
+    void LRUReplacer::GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const {
+        for (frame_id_t fid = tail_; fid != INVALID_FRAME_ID && candidates->size() < max_count; fid = prev_[fid]) {
+            candidates->push_back(fid);
+        }
+    }
+
+    // ---------------- CLOCK ----------------
+    ClockReplacer::ClockReplacer(size_t num_frames)
+        : ref_bits_(num_frames), in_use_(num_frames, false) {}
+
+    void ClockReplacer::RecordLoad(frame_id_t frame_id, PageID /*page_id*/, AccessType type) {
+        in_use_[frame_id] = true;
+        ref_bits_[frame_id].store(type == AccessType::NORMAL ? 1 : 0, std::memory_order_relaxed);
+    }
+
+    void ClockReplacer::RecordAccess(frame_id_t frame_id, AccessType type) {
+        // 已置位时不再写，避免热页的缓存行在各核之间来回失效
+        if (type == AccessType::NORMAL && ref_bits_[frame_id].load(std::memory_order_relaxed) == 0) {
+            ref_bits_[frame_id].store(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool ClockReplacer::Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) {
+        size_t n = ref_bits_.size();
+        if (n == 0) {
+            return false;
+        }
+        // 最多转两圈：第一圈清除引用位，第二圈必能遇到未被引用的帧（除非全部被 pin 住）
+        for (size_t step = 0; step < 2 * n; step++) {
+            frame_id_t fid = static_cast<frame_id_t>(hand_);
+            hand_ = (hand_ + 1) % n;
+            if (!in_use_[fid]) {
+                continue;
+            }
+            if (ref_bits_[fid].load(std::memory_order_relaxed)) {
+                ref_bits_[fid].store(0, std::memory_order_relaxed);
+                continue;
+            }
+            if (!is_evictable(fid)) {
+                continue;
+            }
+            in_use_[fid] = false;
+            *victim = fid;
+            return true;
+        }
+        return false;
+    }
+
+    void ClockReplacer::Remove(frame_id_t frame_id) {
+        in_use_[frame_id] = false;
+        ref_bits_[frame_id].store(0, std::memory_order_relaxed);
+    }
+
+    void ClockReplacer::GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const {
+        // 时钟指针前方引用位为 0 的帧会最先被淘汰
+        size_t n = ref_bits_.size();
+        for (size_t step = 0; step < n && candidates->size() < max_count; step++) {
+            size_t fid = (hand_ + step) % n;
+            if (in_use_[fid] && !ref_bits_[fid].load(std::memory_order_relaxed)) {
+                candidates->push_back(static_cast<frame_id_t>(fid));
+            }
+        }
+    }
+
+    // ---------------- CLOCK-Pro ----------------
+    ClockProReplacer::ClockProReplacer(size_t num_frames)
+        : capacity_(num_frames), cold_target_(std::max<size_t>(1, num_frames / 2)),
+          entries_(2 * num_frames + 1), frame_entry_(num_frames, -1), history_(num_frames + 1) {
+        // 环上最多同时存在 num_frames 个驻留页和 num_frames 个非驻留页
+        free_entries_.reserve(entries_.size());
+        for (int i = static_cast<int>(entries_.size()) - 1; i >= 0; i--) {
+            free_entries_.push_back(i);
+        }
+    }
+
+    int ClockProReplacer::NewEntry(PageID page_id, frame_id_t frame_id, State state) {
+        int idx = free_entries_.back();
+        free_entries_.pop_back();
+        Entry& e = entries_[idx];
+        e.page_id = page_id;
+        e.frame_id = frame_id;
+        e.state = state;
+        e.ref = false;
+        e.test = false;
+        return idx;
+    }
+
+    void ClockProReplacer::FreeEntry(int idx) {
+        entries_[idx].state = State::FREE;
+        entries_[idx].frame_id = INVALID_FRAME_ID;
+        free_entries_.push_back(idx);
+    }
+
+    void ClockProReplacer::InsertAtHead(int idx) {
+        Entry& e = entries_[idx];
+        if (hand_hot_ == -1) {
+            e.prev = e.next = idx;
+            hand_hot_ = hand_cold_ = hand_test_ = idx;
+            return;
+        }
+        int next = hand_hot_;
+        int prev = entries_[next].prev;
+        e.prev = prev;
+        e.next = next;
+        entries_[prev].next = idx;
+        entries_[next].prev = idx;
+    }
+
+    void ClockProReplacer::Unlink(int idx) {
+        Entry& e = entries_[idx];
+        if (e.next == idx) {
+            hand_hot_ = hand_cold_ = hand_test_ = -1;
+        } else {
+            if (hand_hot_ == idx) hand_hot_ = e.next;
+            if (hand_cold_ == idx) hand_cold_ = e.next;
+            if (hand_test_ == idx) hand_test_ = e.next;
+            entries_[e.prev].next = e.next;
+            entries_[e.next].prev = e.prev;
+        }
+        e.prev = e.next = -1;
+    }
+
+    void ClockProReplacer::MoveToHead(int idx) {
+        Unlink(idx);
+        InsertAtHead(idx);
+    }
+
+    void ClockProReplacer::Promote(int idx) {
+        Entry& e = entries_[idx];
+        e.state = State::HOT;
+        e.test = false;
+        e.ref = false;
+        cold_count_--;
+        hot_count_++;
+        MoveToHead(idx);
+        while (hot_count_ > capacity_ - cold_target_ && RunHandHot()) {
+        }
+    }
+
+    void ClockProReplacer::RecordLoad(frame_id_t frame_id, PageID page_id, AccessType type) {
+        Remove(frame_id);
+        int idx;
+        if (type == AccessType::SEQUENTIAL) {
+            // 顺序访问：作为不在测试期的 cold 页载入，淘汰后不留非驻留记录
+            idx = NewEntry(page_id, frame_id, State::COLD);
+            cold_count_++;
+            InsertAtHead(idx);
+        } else if (history_.Find(page_id, &idx)) {
+            // 测试期内再次访问：说明冷页空间不足，增大冷页目标并直接以 hot 身份载入
+            history_.Erase(page_id);
+            Unlink(idx);
+            non_resident_count_--;
+            cold_target_ = std::min(cold_target_ + 1, capacity_ > 1 ? capacity_ - 1 : 1);
+            Entry& e = entries_[idx];
+            e.state = State::HOT;
+            e.frame_id = frame_id;
+            e.ref = false;
+            e.test = false;
+            hot_count_++;
+            InsertAtHead(idx);
+            while (hot_count_ > capacity_ - cold_target_ && RunHandHot()) {
+            }
+        } else {
+            idx = NewEntry(page_id, frame_id, State::COLD);
+            entries_[idx].test = true;
+            cold_count_++;
+            InsertAtHead(idx);
+        }
+        frame_entry_[frame_id] = idx;
+    }
+
+    void ClockProReplacer::RecordAccess(frame_id_t frame_id, AccessType type) {
+        int idx = frame_entry_[frame_id];
+        if (idx >= 0 && type == AccessType::NORMAL) {
+            entries_[idx].ref = true;
+        }
+    }
+
+    bool ClockProReplacer::RunHandHot() {
+        // hot 指针：清除 hot 页引用位，遇到未被引用的 hot 页则降级为 cold；
+        // 沿途结束 cold 页的测试期，并回收非驻留页
+        size_t limit = 2 * entries_.size();
+        for (size_t step = 0; step < limit && hand_hot_ != -1 && hot_count_ > 0; step++) {
+            int idx = hand_hot_;
+            Entry& e = entries_[idx];
+            if (e.state == State::HOT) {
+                hand_hot_ = e.next;
+                if (e.ref) {
+                    e.ref = false;
+                } else {
+                    e.state = State::COLD;
+                    e.test = false;
+                    hot_count_--;
+                    cold_count_++;
+                    return true;
+                }
+            } else if (e.state == State::COLD) {
+                hand_hot_ = e.next;
+                if (e.test) {
+                    e.test = false;
+                    cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+                }
+            } else {
+                // 非驻留页测试期结束，直接丢弃
+                history_.Erase(e.page_id);
+                Unlink(idx);
+                FreeEntry(idx);
+                non_resident_count_--;
+                cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+            }
+        }
+        return false;
+    }
+
+    void ClockProReplacer::RunHandTest() {
+        // test 指针：非驻留页数超过容量时，回收最老的非驻留页
+        size_t limit = 2 * entries_.size();
+        for (size_t step = 0; step < limit && non_resident_count_ > capacity_ && hand_test_ != -1; step++) {
+            int idx = hand_test_;
+            Entry& e = entries_[idx];
+            if (e.state == State::NON_RESIDENT) {
+                history_.Erase(e.page_id);
+                Unlink(idx);
+                FreeEntry(idx);
+                non_resident_count_--;
+                cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+            } else {
+                hand_test_ = e.next;
+                if (e.state == State::COLD && e.test) {
+                    e.test = false;
+                    cold_target_ = std::max<size_t>(1, cold_target_ - 1);
+                }
+            }
+        }
+    }
+
+    bool ClockProReplacer::Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) {
+        size_t limit = 4 * entries_.size() + 4;
+        for (size_t step = 0; step < limit && hand_cold_ != -1; step++) {
+            if (cold_count_ == 0) {
+                // 没有 cold 页可淘汰时先让 hot 指针降级一个 hot 页
+                if (!RunHandHot()) {
+                    return false;
+                }
+                continue;
+            }
+            int idx = hand_cold_;
+            Entry& e = entries_[idx];
+            if (e.state != State::COLD) {
+                hand_cold_ = e.next;
+                continue;
+            }
+            if (e.ref) {
+                e.ref = false;
+                if (e.test) {
+                    // 测试期内被再次访问，提升为 hot
+                    Promote(idx);
+                } else {
+                    e.test = true;
+                    MoveToHead(idx);
+                }
+                continue;
+            }
+            if (!is_evictable(e.frame_id)) {
+                hand_cold_ = e.next;
+                continue;
+            }
+            // 淘汰该 cold 页
+            *victim = e.frame_id;
+            frame_entry_[e.frame_id] = -1;
+            cold_count_--;
+            hand_cold_ = e.next;
+            if (e.test) {
+                // 仍在测试期：保留为非驻留页，记住它的 PageID
+                e.state = State::NON_RESIDENT;
+                e.frame_id = INVALID_FRAME_ID;
+                history_.Insert(e.page_id, idx);
+                non_resident_count_++;
+                if (non_resident_count_ > capacity_) {
+                    RunHandTest();
+                }
+            } else {
+                Unlink(idx);
+                FreeEntry(idx);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void ClockProReplacer::Remove(frame_id_t frame_id) {
+        int idx = frame_entry_[frame_id];
+        if (idx < 0) {
+            return;
+        }
+        if (entries_[idx].state == State::HOT) {
+            hot_count_--;
+        } else {
+            cold_count_--;
+        }
+        frame_entry_[frame_id] = -1;
+        Unlink(idx);
+        FreeEntry(idx);
+    }
+
+    void ClockProReplacer::GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const {
+        // cold 指针前方未被引用的 cold 页会最先被淘汰
+        if (hand_cold_ == -1) {
+            return;
+        }
+        int idx = hand_cold_;
+        do {
+            const Entry& e = entries_[idx];
+            if (e.state == State::COLD && !e.ref) {
+                candidates->push_back(e.frame_id);
+            }
+            idx = e.next;
+        } while (idx != hand_cold_ && candidates->size() < max_count);
+    }
+
+    void ClockProReplacer::SetCapacity(size_t num_frames) {
+        // 缩小后多出的 hot 页和非驻留页在后续的 RunHandHot/RunHandTest 中逐步降级、清除
+        capacity_ = std::max<size_t>(1, num_frames);
+        cold_target_ = std::min(cold_target_, capacity_ > 1 ? capacity_ - 1 : 1);
+    }
+
+    // ---------------- 2Q ----------------
+    TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+        : a1in_target_(std::max<size_t>(1, num_frames / 4)),
+          prev_(num_frames, INVALID_FRAME_ID), next_(num_frames, INVALID_FRAME_ID),
+          queue_(num_frames, NONE), frame_page_(num_frames, INVALID_PAGE_ID), sequential_(num_frames, false),
+          a1out_ring_(std::max<size_t>(1, num_frames / 2), INVALID_PAGE_ID),
+          a1out_(std::max<size_t>(1, num_frames / 2)) {
+        // 论文推荐 Kin = 25% 帧数，Kout = 50% 帧数
+    }
+
+    void TwoQueueReplacer::PushFront(List& list, Queue queue, frame_id_t frame_id) {
+        prev_[frame_id] = INVALID_FRAME_ID;
+        next_[frame_id] = list.head;
+        if (list.head != INVALID_FRAME_ID) {
+            prev_[list.head] = frame_id;
+        }
+        list.head = frame_id;
+        if (list.tail == INVALID_FRAME_ID) {
+            list.tail = frame_id;
+        }
+        list.size++;
+        queue_[frame_id] = queue;
+    }
+
+    void TwoQueueReplacer::Unlink(frame_id_t frame_id) {
+        List& list = queue_[frame_id] == A1IN ? a1in_ : am_;
+        if (prev_[frame_id] != INVALID_FRAME_ID) {
+            next_[prev_[frame_id]] = next_[frame_id];
+        } else {
+            list.head = next_[frame_id];
+        }
+        if (next_[frame_id] != INVALID_FRAME_ID) {
+            prev_[next_[frame_id]] = prev_[frame_id];
+        } else {
+            list.tail = prev_[frame_id];
+        }
+        prev_[frame_id] = next_[frame_id] = INVALID_FRAME_ID;
+        list.size--;
+        queue_[frame_id] = NONE;
+    }
+
+    void TwoQueueReplacer::RememberEvicted(PageID page_id) {
+        // 覆盖环中最老的位置，被覆盖的 PageID 同时移出 A1out
+        PageID oldest = a1out_ring_[a1out_cursor_];
+        frame_id_t slot;
+        if (oldest != INVALID_PAGE_ID && a1out_.Find(oldest, &slot) && slot == static_cast<frame_id_t>(a1out_cursor_)) {
+            a1out_.Erase(oldest);
+        }
+        a1out_.Erase(page_id);
+        a1out_ring_[a1out_cursor_] = page_id;
+        a1out_.Insert(page_id, static_cast<frame_id_t>(a1out_cursor_));
+        a1out_cursor_ = (a1out_cursor_ + 1) % a1out_ring_.size();
+    }
+
+    void TwoQueueReplacer::RecordLoad(frame_id_t frame_id, PageID page_id, AccessType type) {
+        Remove(frame_id);
+        frame_page_[frame_id] = page_id;
+        sequential_[frame_id] = type == AccessType::SEQUENTIAL;
+        frame_id_t slot;
+        if (type == AccessType::NORMAL && a1out_.Find(page_id, &slot)) {
+            // 在 A1out 中命中：该页在较短时间内被再次访问，进入 Am
+            a1out_.Erase(page_id);
+            a1out_ring_[slot] = INVALID_PAGE_ID;
+            PushFront(am_, AM, frame_id);
+        } else {
+            PushFront(a1in_, A1IN, frame_id);
+        }
+    }
+
+    void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, AccessType type) {
+        // A1in 中的命中视为相关访问，不提升；Am 中的命中按 LRU 前移
+        if (type == AccessType::NORMAL && queue_[frame_id] == AM && am_.head != frame_id) {
+            Unlink(frame_id);
+            PushFront(am_, AM, frame_id);
+        }
+    }
+
+    bool TwoQueueReplacer::EvictFrom(List& list, const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) {
+        for (frame_id_t fid = list.tail; fid != INVALID_FRAME_ID; fid = prev_[fid]) {
+            if (is_evictable(fid)) {
+                Unlink(fid);
+                *victim = fid;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TwoQueueReplacer::Evict(const std::function<bool(frame_id_t)>& is_evictable, frame_id_t* victim) {
+        // A1in 超过 Kin 时优先淘汰 A1in 队尾，否则淘汰 Am 的 LRU 页
+        bool from_a1in = a1in_.size > a1in_target_ || am_.size == 0;
+        if (from_a1in) {
+            if (EvictFrom(a1in_, is_evictable, victim)) {
+                if (!sequential_[*victim]) {
+                    RememberEvicted(frame_page_[*victim]);
+                }
+                frame_page_[*victim] = INVALID_PAGE_ID;
+                return true;
+            }
+            if (!EvictFrom(am_, is_evictable, victim)) {
+                return false;
+            }
+        } else if (!EvictFrom(am_, is_evictable, victim)) {
+            if (!EvictFrom(a1in_, is_evictable, victim)) {
+                return false;
+            }
+            if (!sequential_[*victim]) {
+                RememberEvicted(frame_page_[*victim]);
+            }
+        }
+        frame_page_[*victim] = INVALID_PAGE_ID;
+        return true;
+    }
+
+    void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+        if (queue_[frame_id] != NONE) {
+            Unlink(frame_id);
+        }
+        frame_page_[frame_id] = INVALID_PAGE_ID;
+    }
+
+    void TwoQueueReplacer::GetEvictionCandidates(size_t max_count, std::vector<frame_id_t>* candidates) const {
+        // 先列出 A1in 超出 Kin 的部分，再列出 Am 的 LRU 端，最后是 A1in 余下的部分
+        size_t a1in_over = a1in_.size > a1in_target_ ? a1in_.size - a1in_target_ : 0;
+        frame_id_t fid = a1in_.tail;
+        for (; fid != INVALID_FRAME_ID && a1in_over > 0 && candidates->size() < max_count; fid = prev_[fid], a1in_over--) {
+            candidates->push_back(fid);
+        }
+        for (frame_id_t am = am_.tail; am != INVALID_FRAME_ID && candidates->size() < max_count; am = prev_[am]) {
+            candidates->push_back(am);
+        }
+        for (; fid != INVALID_FRAME_ID && candidates->size() < max_count; fid = prev_[fid]) {
+            candidates->push_back(fid);
+        }
+    }
+
+    void TwoQueueReplacer::SetCapacity(size_t num_frames) {
+        // A1out 的长度保持构造时的值，只调整 Kin
+        a1in_target_ = std::max<size_t>(1, num_frames / 4);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+// 页校验和：CRC32C 的已知向量（RFC 3720 等），硬件实现（SSE4.2）与查表实现在各种长度、对齐和
+// 分段计算下结果一致；页校验和发现字节翻转与错位写入；磁盘上被破坏的页经缓冲池读取时被拒绝
+#include "lightdb/buffer_pool.h"
+#include "lightdb/checksum.h"
+#include "lightdb/logger.h"
+#include "test_util.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* DATA_FILE = "test_checksum.db";
+    const int32_t NUM_PAGES = 8;
+    const int32_t CORRUPTED_PAGE = 3;
+    const int32_t MISPLACED_PAGE = 6; //被写入了第 5 页的内容（含第 5 页的校验和）
+
+    void CheckBothImpls(const std::string& data, uint32_t expected) {
+        CHECK(lightdb::Crc32c(data.data(), data.size()) == expected);
+        CHECK(lightdb::Crc32cPortable(data.data(), data.size()) == expected);
+    }
+
+    void TestKnownVectors() {
+        CheckBothImpls("", 0);
+        CheckBothImpls("123456789", 0xE3069283);
+        CheckBothImpls(std::string(32, '\0'), 0x8A9136AA);
+        CheckBothImpls(std::string(32, '\xFF'), 0x62A8AB43);
+        std::string ascending(32, 0);
+        std::string descending(32, 0);
+        for (int i = 0; i < 32; i++) {
+            ascending[i] = static_cast<char>(i);
+            descending[i] = static_cast<char>(31 - i);
+        }
+        CheckBothImpls(ascending, 0x46DD794E);
+        CheckBothImpls(descending, 0x113FDB5C);
+    }
+
+    void TestImplsAgree() {
+        std::printf("Crc32c implementation: %s\n", lightdb::Crc32cImplName());
+        std::mt19937 rng(7);
+        std::vector<char> buffer(3 * lightdb::PAGE_SIZE);
+        for (char& c : buffer) {
+            c = static_cast<char>(rng());
+        }
+        // 覆盖逐字节、8 字节和三段交错的各条路径，以及不对齐的起始地址
+        for (size_t length : {1u, 3u, 7u, 8u, 9u, 63u, 1360u, 4079u, 4080u, 4081u, 4092u, 8191u, 9000u}) {
+            for (size_t offset : {0u, 1u, 5u}) {
+                const char* data = buffer.data() + offset;
+                uint32_t expected = lightdb::Crc32cPortable(data, length);
+                CHECK(lightdb::Crc32c(data, length) == expected);
+                // 分段计算与整体计算相同
+                size_t split = length / 3;
+                CHECK(lightdb::Crc32c(data + split, length - split, lightdb::Crc32c(data, split)) == expected);
+                CHECK(lightdb::Crc32cPortable(data + split, length - split, lightdb::Crc32cPortable(data, split)) ==
+                      expected);
+            }
+        }
+    }
+
+    void TestPageChecksum() {
+        std::vector<char> page(lightdb::PAGE_SIZE, 0);
+        CHECK(lightdb::VerifyPageChecksum(page.data(), 9)); //从未写过的全零页
+        for (int i = 0; i < lightdb::PAGE_DATA_SIZE; i++) {
+            page[i] = static_cast<char>(i * 31);
+        }
+        lightdb::SetPageChecksum(page.data(), 9);
+        CHECK(lightdb::VerifyPageChecksum(page.data(), 9));
+        CHECK(!lightdb::VerifyPageChecksum(page.data(), 10)); //写到了错误的位置
+        for (int pos : {0, 1, 100, lightdb::PAGE_DATA_SIZE - 1, lightdb::PAGE_DATA_SIZE}) {
+            page[pos] ^= 0x10;
+            CHECK(!lightdb::VerifyPageChecksum(page.data(), 9));
+            page[pos] ^= 0x10;
+        }
+        CHECK(lightdb::VerifyPageChecksum(page.data(), 9));
+    }
+
+    void FillPage(char* data, int32_t page_no) {
+        for (int i = 0; i < lightdb::PAGE_DATA_SIZE; i++) {
+            data[i] = static_cast<char>('a' + (page_no + i) % 26);
+        }
+    }
+
+    void CorruptOnDisk() {
+        int fd = open(DATA_FILE, O_RDWR);
+        CHECK(fd >= 0);
+        char byte;
+        off_t offset = static_cast<off_t>(CORRUPTED_PAGE) * lightdb::PAGE_SIZE + 100;
+        CHECK(pread(fd, &byte, 1, offset) == 1);
+        byte ^= 0x01;
+        CHECK(pwrite(fd, &byte, 1, offset) == 1);
+        std::vector<char> page(lightdb::PAGE_SIZE);
+        CHECK(pread(fd, page.data(), page.size(), static_cast<off_t>(MISPLACED_PAGE - 1) * lightdb::PAGE_SIZE) ==
+              lightdb::PAGE_SIZE);
+        CHECK(pwrite(fd, page.data(), page.size(), static_cast<off_t>(MISPLACED_PAGE) * lightdb::PAGE_SIZE) ==
+              lightdb::PAGE_SIZE);
+        close(fd);
+    }
+
+    void TestCorruptedPageRejected() {
+        std::remove(DATA_FILE);
+        lightdb::DiskManager dm;
+        lightdb::FileID file_id = dm.OpenFile(DATA_FILE);
+        CHECK(file_id != lightdb::INVALID_FILE_ID);
+        {
+            lightdb::BufferPool pool(16, &dm);
+            for (int32_t page_no = 0; page_no < NUM_PAGES; page_no++) {
+                lightdb::WritePageGuard guard = pool.FetchPageWrite(lightdb::MakePageID(file_id, page_no));
+                CHECK(guard);
+                FillPage(guard.GetDataMut(), page_no);
+            }
+            CHECK(pool.FlushAll());
+        }
+        CorruptOnDisk();
+
+        for (lightdb::ChecksumVerify verify : {lightdb::ChecksumVerify::ALWAYS, lightdb::ChecksumVerify::SKIP_SELF_WRITTEN}) {
+            lightdb::BufferPoolConfig config;
+            config.verify_checksums = verify;
+            lightdb::BufferPool pool(16, &dm, config);
+            std::vector<char> expected(lightdb::PAGE_DATA_SIZE);
+            for (int32_t page_no = 0; page_no < NUM_PAGES; page_no++) {
+                lightdb::ReadPageGuard guard = pool.FetchPageRead(lightdb::MakePageID(file_id, page_no));
+                bool damaged = page_no == CORRUPTED_PAGE || page_no == MISPLACED_PAGE;
+                CHECK(static_cast<bool>(guard) == !damaged);
+                if (guard) {
+                    FillPage(expected.data(), page_no);
+                    CHECK(memcmp(guard.GetData(), expected.data(), expected.size()) == 0);
+                }
+            }
+            CHECK(pool.GetStats().checksum_failures == 2);
+            // 批量取页只有被破坏的页失败
+            std::vector<lightdb::PageID> page_ids;
+            for (int32_t page_no = 2; page_no < 5; page_no++) {
+                page_ids.push_back(lightdb::MakePageID(file_id, page_no));
+            }
+            std::vector<lightdb::Page*> pages = pool.FetchPages(page_ids);
+            CHECK(pages.size() == 3 && pages[0] != nullptr && pages[1] == nullptr && pages[2] != nullptr);
+            for (size_t i = 0; i < pages.size(); i++) {
+                if (pages[i] != nullptr) {
+                    pool.UnpinPage(page_ids[i], false);
+                }
+            }
+            // 关闭校验的扫描可以读出被破坏的页
+            lightdb::BufferAccessStrategy strategy(pool);
+            strategy.SetChecksumVerify(lightdb::ChecksumVerify::NEVER);
+            lightdb::PageID corrupted = lightdb::MakePageID(file_id, CORRUPTED_PAGE);
+            lightdb::Page* page = pool.FetchPage(corrupted, &strategy);
+            CHECK(page != nullptr);
+            if (page != nullptr) {
+                pool.UnpinPage(corrupted, false);
+            }
+        }
+        std::remove(DATA_FILE);
+    }
+}
+
+int main() {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    TestKnownVectors();
+    TestImplsAgree();
+    TestPageChecksum();
+    TestCorruptedPageRejected();
+    return TEST_RESULT();
+}
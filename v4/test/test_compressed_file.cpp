@@ -0,0 +1,187 @@
+// 压缩页文件（CompressedPageFile）：可压缩页与不可压缩页（原样存储）的读写往返、映射持久化后
+// 旧槽的复用、超出映射末尾的稀疏写、重新打开后的内容一致，以及缺少 .pmap 的非空数据文件被拒绝
+// 同时经 DiskManager 与 HeapFile 检查压缩表重新打开后记录不变
+#include "lightdb/compressed_file.h"
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+#include "test_util.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* DATA_FILE = "test_compressed_file.db";
+    const char* PLAIN_FILE = "test_compressed_plain.db";
+    const char* TABLE_FILE = "test_compressed_table.db";
+    const int SECTOR_SIZE = lightdb::CompressedPageFile::SECTOR_SIZE;
+
+    std::string MapPath(const char* path) {
+        return std::string(path) + ".pmap";
+    }
+
+    off_t FileSize(int fd) {
+        struct stat st;
+        return fstat(fd, &st) == 0 ? st.st_size : -1;
+    }
+
+    std::vector<char> TextPage(int seed) {
+        std::vector<char> page(lightdb::PAGE_SIZE, 0);
+        std::string text = "page " + std::to_string(seed) + ": name=user,city=Hangzhou,status=active;";
+        for (size_t pos = 0; pos + text.size() < page.size() / 2; pos += text.size()) {
+            memcpy(page.data() + pos, text.data(), text.size());
+        }
+        return page;
+    }
+
+    std::vector<char> RandomPage(unsigned seed) {
+        std::mt19937 rng(seed);
+        std::vector<char> page(lightdb::PAGE_SIZE);
+        for (char& c : page) {
+            c = static_cast<char>(rng());
+        }
+        return page;
+    }
+
+    bool PageEquals(lightdb::CompressedPageFile* file, int32_t page_no, const std::vector<char>& expected) {
+        std::vector<char> page(lightdb::PAGE_SIZE, 1);
+        return file->ReadPage(page_no, page.data()) && page == expected;
+    }
+
+    void TestRoundTripAndReopen(int fd) {
+        std::vector<char> text = TextPage(0);
+        std::vector<char> random = RandomPage(1);
+        std::vector<char> zeros(lightdb::PAGE_SIZE, 0);
+        {
+            lightdb::CompressedPageFile file(fd, MapPath(DATA_FILE), lightdb::PageCompression::LZ);
+            CHECK(file.IsValid());
+            CHECK(file.WritePage(0, text.data()));
+            CHECK(file.GetPhysicalBytes() < static_cast<uint64_t>(lightdb::PAGE_SIZE));
+            // 不可压缩的页原样占满整页
+            CHECK(file.WritePage(1, random.data()));
+            uint64_t text_bytes = file.GetPhysicalBytes() - lightdb::PAGE_SIZE;
+            CHECK(text_bytes > 0 && text_bytes % SECTOR_SIZE == 0);
+            CHECK(PageEquals(&file, 0, text));
+            CHECK(PageEquals(&file, 1, random));
+
+            // 稀疏写：跳过的页在映射中为空项，读出全零
+            CHECK(file.WritePage(6, text.data()));
+            CHECK(file.GetNumPages() == 7);
+            for (int32_t page_no = 2; page_no < 6; page_no++) {
+                CHECK(PageEquals(&file, page_no, zeros));
+            }
+            CHECK(PageEquals(&file, 6, text));
+            CHECK(PageEquals(&file, 100, zeros));
+            CHECK(file.GetLogicalBytes() == 3u * lightdb::PAGE_SIZE);
+            // 析构时持久化映射
+        }
+        lightdb::CompressedPageFile file(fd, MapPath(DATA_FILE), lightdb::PageCompression::LZ);
+        CHECK(file.IsValid());
+        CHECK(file.GetNumPages() == 7);
+        CHECK(file.GetLogicalBytes() == 3u * lightdb::PAGE_SIZE);
+        CHECK(PageEquals(&file, 0, text));
+        CHECK(PageEquals(&file, 1, random));
+        for (int32_t page_no = 2; page_no < 6; page_no++) {
+            CHECK(PageEquals(&file, page_no, zeros));
+        }
+        CHECK(PageEquals(&file, 6, text));
+    }
+
+    void TestSlotReuse(int fd) {
+        lightdb::CompressedPageFile file(fd, MapPath(DATA_FILE), lightdb::PageCompression::LZ);
+        CHECK(file.IsValid());
+        std::vector<char> first = TextPage(1);
+        std::vector<char> second = TextPage(2);
+        std::vector<char> third = TextPage(3);
+        CHECK(file.WritePage(0, first.data()));
+        CHECK(file.Sync());
+        off_t size_after_first = FileSize(fd);
+        // 写时复制：映射持久化之前新版本写到新槽，旧槽不能复用
+        CHECK(file.WritePage(0, second.data()));
+        off_t size_after_second = FileSize(fd);
+        CHECK(size_after_second > size_after_first);
+        CHECK(PageEquals(&file, 0, second));
+        // 持久化后旧槽释放，同样大小的新版本写回旧槽，文件不再增长
+        CHECK(file.Sync());
+        CHECK(file.WritePage(0, third.data()));
+        CHECK(FileSize(fd) == size_after_second);
+        CHECK(PageEquals(&file, 0, third));
+        CHECK(file.GetPhysicalBytes() == static_cast<uint64_t>(size_after_second - size_after_first));
+    }
+
+    void TestMissingMapRejected() {
+        // 未压缩方式建立的非空数据文件没有映射，不能当作压缩文件打开
+        lightdb::RemoveTestFiles(PLAIN_FILE);
+        int fd = open(PLAIN_FILE, O_RDWR | O_CREAT, 0644);
+        CHECK(fd >= 0);
+        std::vector<char> page = TextPage(4);
+        CHECK(write(fd, page.data(), page.size()) == static_cast<ssize_t>(page.size()));
+        {
+            lightdb::CompressedPageFile file(fd, MapPath(PLAIN_FILE), lightdb::PageCompression::LZ);
+            CHECK(!file.IsValid());
+        }
+        close(fd);
+        lightdb::DiskManager dm;
+        CHECK(dm.OpenFile(PLAIN_FILE, lightdb::PageCompression::LZ) == lightdb::INVALID_FILE_ID);
+        lightdb::RemoveTestFiles(PLAIN_FILE);
+    }
+
+    std::string MakeRecord(int i) {
+        std::string id = std::to_string(i);
+        return "id=" + id + ",name=user_" + id + ",email=user_" + id + "@example.com,city=Hangzhou";
+    }
+
+    void TestTableReopen() {
+        lightdb::RemoveTestFiles(TABLE_FILE);
+        const int num_records = 20000;
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(256, &dm);
+            lightdb::HeapFile table(TABLE_FILE, &pool, lightdb::StorageMode::BUFFER_POOL, lightdb::PageCompression::LZ);
+            for (int i = 0; i < num_records; i++) {
+                lightdb::Record record;
+                record.data = MakeRecord(i);
+                CHECK(table.InsertRecord(record).page_id != lightdb::INVALID_PAGE_ID);
+            }
+        }
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(16, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool, lightdb::StorageMode::BUFFER_POOL, lightdb::PageCompression::LZ);
+        CHECK(table.GetCompression() == lightdb::PageCompression::LZ);
+        std::vector<lightdb::Record> records = table.SeqScan();
+        CHECK(records.size() == static_cast<size_t>(num_records));
+        for (size_t i = 0; i < records.size(); i++) {
+            CHECK(records[i].data == MakeRecord(static_cast<int>(i)));
+        }
+        uint64_t logical_bytes = 0;
+        uint64_t physical_bytes = 0;
+        CHECK(dm.GetCompressionStats(dm.OpenFile(TABLE_FILE, lightdb::PageCompression::LZ), &logical_bytes,
+                                     &physical_bytes));
+        CHECK(physical_bytes > 0 && physical_bytes < logical_bytes);
+        lightdb::RemoveTestFiles(TABLE_FILE);
+    }
+}
+
+int main() {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    lightdb::RemoveTestFiles(DATA_FILE);
+    int fd = open(DATA_FILE, O_RDWR | O_CREAT, 0644);
+    CHECK(fd >= 0);
+    TestRoundTripAndReopen(fd);
+    close(fd);
+
+    lightdb::RemoveTestFiles(DATA_FILE);
+    fd = open(DATA_FILE, O_RDWR | O_CREAT, 0644);
+    TestSlotReuse(fd);
+    close(fd);
+    lightdb::RemoveTestFiles(DATA_FILE);
+
+    TestMissingMapRejected();
+    TestTableReopen();
+    return TEST_RESULT();
+}
@@ -0,0 +1,221 @@
+// 空闲空间映射：FindPage 与按档位计算的参照结果一致（页号最小者优先，只返回记录的空闲空间够用的页）；
+// 重新打开后从 .fsm 恢复，只有未记录的项读堆页补齐，.fsm 缺失时全部重建；HeapFile 插入时按记录大小
+// 选页；并发插入删除后记录完整
+#include "lightdb/free_space_map.h"
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+#include "test_util.h"
+
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* FSM_FILE = "test_free_space_map.fsm";
+    const char* TABLE_FILE = "test_free_space_map.db";
+    const int CATEGORY = lightdb::FreeSpaceMap::FSM_CATEGORY_BYTES;
+    const int RECORD_SIZE = 100;
+
+    // 参照实现：空闲空间按档位向下取整、需求按档位向上取整后比较
+    int32_t ExpectedPage(const std::vector<int>& free_space, int required) {
+        for (size_t page_no = 0; page_no < free_space.size(); page_no++) {
+            if (free_space[page_no] >= 0 && free_space[page_no] / CATEGORY >= (required + CATEGORY - 1) / CATEGORY) {
+                return static_cast<int32_t>(page_no);
+            }
+        }
+        return -1;
+    }
+
+    void CheckFindPage(lightdb::FreeSpaceMap* fsm, const std::vector<int>& free_space) {
+        for (int required : {1, 16, 17, 100, 500, 1000, 2000, 3000, 4000}) {
+            CHECK(fsm->FindPage(required) == ExpectedPage(free_space, required));
+        }
+    }
+
+    void TestFindPageAndReopen() {
+        std::remove(FSM_FILE);
+        const int32_t num_pages = 300;
+        std::vector<int> free_space(num_pages, -1); //-1 表示未记录
+        std::mt19937 rng(3);
+        std::uniform_int_distribution<int> space(0, lightdb::PAGE_DATA_SIZE);
+        auto never_read = [](int32_t) {
+            CHECK(false);
+            return 0;
+        };
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(16, &dm);
+            lightdb::FreeSpaceMap fsm(FSM_FILE, &pool, 0, never_read);
+            CHECK(fsm.FindPage(1) == -1);
+            // 乱序更新，页号超出已知范围时扩展；同一页多次更新以最后一次为准
+            for (int i = 0; i < 2000; i++) {
+                int32_t page_no = static_cast<int32_t>(rng() % num_pages);
+                if (page_no % 10 == 7) {
+                    continue; //这些页留作未记录
+                }
+                free_space[page_no] = space(rng);
+                fsm.Update(page_no, free_space[page_no]);
+            }
+            CheckFindPage(&fsm, free_space);
+            fsm.Update(num_pages - 1, 0);
+            free_space[num_pages - 1] = 0;
+            CheckFindPage(&fsm, free_space);
+        }
+
+        // 重新打开：已记录的项从 .fsm 读出，只有未记录的页读堆页补齐
+        int reads = 0;
+        auto read_free_space = [&reads](int32_t page_no) {
+            reads++;
+            return page_no * 10;
+        };
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(16, &dm);
+            lightdb::FreeSpaceMap fsm(FSM_FILE, &pool, num_pages, read_free_space);
+            int unrecorded = 0;
+            for (int32_t page_no = 0; page_no < num_pages; page_no++) {
+                if (free_space[page_no] < 0) {
+                    free_space[page_no] = page_no * 10;
+                    unrecorded++;
+                }
+            }
+            CHECK(reads == unrecorded);
+            CheckFindPage(&fsm, free_space);
+        }
+        // 补齐的项也已写回，再次打开不需要读堆页
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(16, &dm);
+            lightdb::FreeSpaceMap fsm(FSM_FILE, &pool, num_pages, never_read);
+            CheckFindPage(&fsm, free_space);
+        }
+        // .fsm 缺失时全部由堆页重建
+        std::remove(FSM_FILE);
+        reads = 0;
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(16, &dm);
+            lightdb::FreeSpaceMap fsm(FSM_FILE, &pool, num_pages, read_free_space);
+            CHECK(reads == num_pages);
+            for (int32_t page_no = 0; page_no < num_pages; page_no++) {
+                free_space[page_no] = page_no * 10;
+            }
+            CheckFindPage(&fsm, free_space);
+        }
+        std::remove(FSM_FILE);
+    }
+
+    lightdb::RID Insert(lightdb::HeapFile* table, int size, char fill) {
+        lightdb::Record record;
+        record.data = std::string(size, fill);
+        return table->InsertRecord(record);
+    }
+
+    // 插入定长记录直到写到 num_full_pages 号页，返回每条记录的 RID；之前的页都已放不下一条记录
+    std::vector<lightdb::RID> FillPages(lightdb::HeapFile* table, int32_t num_full_pages) {
+        std::vector<lightdb::RID> rids;
+        while (rids.empty() || lightdb::GetPageNo(rids.back().page_id) < num_full_pages) {
+            rids.push_back(Insert(table, RECORD_SIZE, 'r'));
+        }
+        return rids;
+    }
+
+    void DeleteOnPage(lightdb::HeapFile* table, const std::vector<lightdb::RID>& rids, int32_t page_no, int count) {
+        for (const lightdb::RID& rid : rids) {
+            if (count > 0 && lightdb::GetPageNo(rid.page_id) == page_no) {
+                CHECK(table->DeleteRecord(rid));
+                count--;
+            }
+        }
+    }
+
+    void TestInsertHonorsSize() {
+        lightdb::RemoveTestFiles(TABLE_FILE);
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(16, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        std::vector<lightdb::RID> rids = FillPages(&table, 4);
+        DeleteOnPage(&table, rids, 0, 3); //约 300 字节空闲
+        DeleteOnPage(&table, rids, 1, 10); //约 1000 字节空闲
+        // 每条记录放进空间足够、页号最小的页；都放不下时才新建页
+        CHECK(lightdb::GetPageNo(Insert(&table, 600, 'a').page_id) == 1);
+        CHECK(lightdb::GetPageNo(Insert(&table, 200, 'b').page_id) == 0);
+        CHECK(lightdb::GetPageNo(Insert(&table, 300, 'c').page_id) == 1);
+        CHECK(lightdb::GetPageNo(Insert(&table, 3000, 'd').page_id) == 4);
+        CHECK(lightdb::GetPageNo(Insert(&table, 3000, 'e').page_id) == 5);
+        CHECK(lightdb::GetPageNo(Insert(&table, 600, 'f').page_id) == 4);
+        lightdb::RemoveTestFiles(TABLE_FILE);
+    }
+
+    void TestTableReopen(bool remove_fsm) {
+        lightdb::RemoveTestFiles(TABLE_FILE);
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(16, &dm);
+            lightdb::HeapFile table(TABLE_FILE, &pool);
+            // 第 2 页腾出空间，页号在它之后的第 5 页也还有空间
+            std::vector<lightdb::RID> rids = FillPages(&table, 5);
+            DeleteOnPage(&table, rids, 2, 12);
+        }
+        if (remove_fsm) {
+            std::remove((std::string(TABLE_FILE) + ".fsm").c_str());
+        }
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(16, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        lightdb::RID rid = Insert(&table, 1000, 'x');
+        CHECK(lightdb::GetPageNo(rid.page_id) == 2);
+        CHECK(table.ReadRecord(rid).data == std::string(1000, 'x'));
+        lightdb::RemoveTestFiles(TABLE_FILE);
+    }
+
+    void TestConcurrentInsertDelete() {
+        lightdb::RemoveTestFiles(TABLE_FILE);
+        const int num_threads = 4;
+        const int per_thread = 5000;
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(64, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        std::vector<std::vector<lightdb::RID>> kept(num_threads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++) {
+            threads.emplace_back([&table, &kept, t]() {
+                std::vector<lightdb::RID> rids;
+                for (int i = 0; i < per_thread; i++) {
+                    lightdb::Record record;
+                    record.data = std::to_string(t) + ":" + std::to_string(i) + std::string(i % 200, 'p');
+                    rids.push_back(table.InsertRecord(record));
+                    if (i % 2 == 1) {
+                        CHECK(table.DeleteRecord(rids[i - 1]));
+                    }
+                }
+                for (int i = 1; i < per_thread; i += 2) {
+                    kept[t].push_back(rids[i]);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (int t = 0; t < num_threads; t++) {
+            for (size_t k = 0; k < kept[t].size(); k++) {
+                int i = static_cast<int>(2 * k + 1);
+                CHECK(table.ReadRecord(kept[t][k]).data ==
+                      std::to_string(t) + ":" + std::to_string(i) + std::string(i % 200, 'p'));
+            }
+        }
+        CHECK(table.SeqScan().size() == static_cast<size_t>(num_threads * per_thread / 2));
+        lightdb::RemoveTestFiles(TABLE_FILE);
+    }
+}
+
+int main() {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    TestFindPageAndReopen();
+    TestInsertHonorsSize();
+    TestTableReopen(false);
+    TestTableReopen(true);
+    TestConcurrentInsertDelete();
+    return TEST_RESULT();
+}
@@ -0,0 +1,139 @@
+// 堆页（槽式页）：删除后整理页内空间，其余记录的 RID 不变（重新打开后也能读到）；已删除的槽被
+// 之后的插入复用，末尾的已删除槽被去掉，页在记录删光后恢复全部容量；反复插入删除不会让表增长；
+// 空页也放不下的记录被拒绝
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+#include "test_util.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "test_heap_page.db";
+    const char* CHURN_FILE = "test_heap_page_churn.db";
+    const int MAX_RECORD_SIZE =
+        lightdb::PAGE_DATA_SIZE - static_cast<int>(sizeof(lightdb::HeapPageHeader) + sizeof(lightdb::HeapSlot));
+    // FSM 以 16 字节为档位且有上限，接近整页的记录查不到已有的页，这里取一个 FSM 能找到的大小
+    const int LARGE_RECORD_SIZE = 4000;
+
+    std::string MakeData(int i) {
+        return std::to_string(i) + ":" + std::string(50 + i % 100, static_cast<char>('a' + i % 26));
+    }
+
+    lightdb::RID Insert(lightdb::HeapFile* table, const std::string& data) {
+        lightdb::Record record;
+        record.data = data;
+        return table->InsertRecord(record);
+    }
+
+    void TestDeleteCompactAndReopen() {
+        lightdb::RemoveTestFiles(TABLE_FILE);
+        const int num_records = 300;
+        std::vector<lightdb::RID> rids;
+        {
+            lightdb::DiskManager dm;
+            lightdb::BufferPool pool(64, &dm);
+            lightdb::HeapFile table(TABLE_FILE, &pool);
+            for (int i = 0; i < num_records; i++) {
+                rids.push_back(Insert(&table, MakeData(i)));
+                CHECK(rids.back().page_id != lightdb::INVALID_PAGE_ID);
+            }
+            CHECK(lightdb::GetPageNo(rids.back().page_id) > 1);
+            for (int i = 0; i < num_records; i += 3) {
+                CHECK(table.DeleteRecord(rids[i]));
+            }
+            CHECK(!table.DeleteRecord(rids[0])); //已删除
+            // 整理页内空间移动了记录，未删除记录的 RID 仍指向原来的数据
+            for (int i = 0; i < num_records; i++) {
+                lightdb::Record record = table.ReadRecord(rids[i]);
+                if (i % 3 == 0) {
+                    CHECK(!table.ReadRecordRef(rids[i]));
+                } else {
+                    CHECK(record.rid == rids[i]);
+                    CHECK(record.data == MakeData(i));
+                }
+            }
+            // 第 0 页有了空间，新记录复用其中第一个已删除的槽
+            lightdb::RID reused = Insert(&table, "reused");
+            CHECK(reused == rids[0]);
+            CHECK(table.ReadRecord(reused).data == "reused");
+            CHECK(table.SeqScan().size() == static_cast<size_t>(num_records - (num_records + 2) / 3 + 1));
+        }
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(16, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        CHECK(table.ReadRecord(rids[0]).data == "reused");
+        for (int i = 1; i < num_records; i++) {
+            if (i % 3 != 0) {
+                CHECK(table.ReadRecord(rids[i]).data == MakeData(i));
+            }
+        }
+        lightdb::RemoveTestFiles(TABLE_FILE);
+    }
+
+    void TestFullCapacityRestored() {
+        lightdb::RemoveTestFiles(TABLE_FILE);
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(16, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        // 填满第 0 页
+        std::vector<lightdb::RID> rids;
+        for (int i = 0;; i++) {
+            lightdb::RID rid = Insert(&table, std::string(100, 'x'));
+            if (lightdb::GetPageNo(rid.page_id) != 0) {
+                break;
+            }
+            rids.push_back(rid);
+        }
+        CHECK(rids.size() > 30);
+        // 先删末尾的记录：末尾的已删除槽立即去掉，之后的插入仍追加在末尾
+        CHECK(table.DeleteRecord(rids.back()));
+        lightdb::RID appended = Insert(&table, std::string(100, 'y'));
+        CHECK(appended == rids.back());
+        // 删光第 0 页，槽数组随之清空：比原先槽数组之外的空间更大的记录也能放进这一页的 0 号槽
+        for (const lightdb::RID& rid : rids) {
+            CHECK(table.DeleteRecord(rid));
+        }
+        std::string large(LARGE_RECORD_SIZE, 'z');
+        CHECK(LARGE_RECORD_SIZE > MAX_RECORD_SIZE - static_cast<int>(rids.size() * sizeof(lightdb::HeapSlot)));
+        lightdb::RID large_rid = Insert(&table, large);
+        CHECK(lightdb::GetPageNo(large_rid.page_id) == 0 && large_rid.slot_id == 0);
+        CHECK(table.ReadRecord(large_rid).data == large);
+        CHECK(Insert(&table, std::string(MAX_RECORD_SIZE, 'z')).page_id != lightdb::INVALID_PAGE_ID);
+        // 空页也放不下的记录直接拒绝
+        CHECK(Insert(&table, std::string(MAX_RECORD_SIZE + 1, 'z')).page_id == lightdb::INVALID_PAGE_ID);
+        lightdb::RemoveTestFiles(TABLE_FILE);
+    }
+
+    void TestChurnDoesNotGrow() {
+        lightdb::RemoveTestFiles(CHURN_FILE);
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(16, &dm);
+        lightdb::HeapFile table(CHURN_FILE, &pool);
+        lightdb::RID keep = Insert(&table, "keep");
+        // 每轮插入一批记录后删掉除第一条之外的全部：槽被复用或去掉，表始终只有一页
+        for (int round = 0; round < 200; round++) {
+            std::vector<lightdb::RID> rids;
+            for (int i = 0; i < 20; i++) {
+                rids.push_back(Insert(&table, MakeData(round * 20 + i)));
+                CHECK(lightdb::GetPageNo(rids.back().page_id) == 0);
+            }
+            for (const lightdb::RID& rid : rids) {
+                CHECK(table.DeleteRecord(rid));
+            }
+        }
+        CHECK(table.ReadRecord(keep).data == "keep");
+        CHECK(table.SeqScan().size() == 1);
+        lightdb::RID next = Insert(&table, "next");
+        CHECK(lightdb::GetPageNo(next.page_id) == 0 && next.slot_id == 1);
+        lightdb::RemoveTestFiles(CHURN_FILE);
+    }
+}
+
+int main() {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    TestDeleteCompactAndReopen();
+    TestFullCapacityRestored();
+    TestChurnDoesNotGrow();
+    return TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+// 页表：随机插入删除后与 std::unordered_map 的结果一致（向后移位删除不会断开探测链）；
+// INVALID_PAGE_ID 与空槽编码相同，对它的 Find/Insert/Erase 都返回 false 且不改动表
+#include "lightdb/page_table.h"
+#include "test_util.h"
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    const size_t MAX_ENTRIES = 64;
+
+    void CheckSame(const lightdb::PageTable& table, const std::unordered_map<lightdb::PageID, lightdb::frame_id_t>& expected,
+                   const std::vector<lightdb::PageID>& keys) {
+        CHECK(table.Size() == expected.size());
+        for (lightdb::PageID page_id : keys) {
+            lightdb::frame_id_t frame_id = lightdb::INVALID_FRAME_ID;
+            auto it = expected.find(page_id);
+            CHECK(table.Find(page_id, &frame_id) == (it != expected.end()));
+            if (it != expected.end()) {
+                CHECK(frame_id == it->second);
+            }
+        }
+    }
+
+    void TestRandomOps() {
+        lightdb::PageTable table(MAX_ENTRIES);
+        std::unordered_map<lightdb::PageID, lightdb::frame_id_t> expected;
+        // 两个文件的页号混在一起，键的数量多于容量的一半，探测链足够长且会绕回表头
+        std::vector<lightdb::PageID> keys;
+        for (int32_t page_no = 0; page_no < 100; page_no++) {
+            keys.push_back(lightdb::MakePageID(1, page_no));
+            keys.push_back(lightdb::MakePageID(2, page_no));
+        }
+        std::mt19937 rng(11);
+        for (int i = 0; i < 20000; i++) {
+            lightdb::PageID page_id = keys[rng() % keys.size()];
+            if (rng() % 2 == 0) {
+                bool inserted = expected.size() < MAX_ENTRIES && expected.count(page_id) == 0;
+                if (inserted) {
+                    CHECK(table.Insert(page_id, i));
+                    expected[page_id] = i;
+                } else if (expected.count(page_id) != 0) {
+                    CHECK(!table.Insert(page_id, i));
+                }
+            } else {
+                CHECK(table.Erase(page_id) == (expected.erase(page_id) == 1));
+            }
+            if (i % 1000 == 0) {
+                CheckSame(table, expected, keys);
+            }
+        }
+        CheckSame(table, expected, keys);
+    }
+
+    void TestInvalidPageId() {
+        lightdb::PageTable table(MAX_ENTRIES);
+        std::unordered_map<lightdb::PageID, lightdb::frame_id_t> expected;
+        std::vector<lightdb::PageID> keys;
+        for (int32_t page_no = 0; page_no < static_cast<int32_t>(MAX_ENTRIES); page_no++) {
+            lightdb::PageID page_id = lightdb::MakePageID(3, page_no);
+            keys.push_back(page_id);
+            CHECK(table.Insert(page_id, page_no));
+            expected[page_id] = page_no;
+        }
+        // 表已满，空槽仍然占一半：对 INVALID_PAGE_ID 的操作不能匹配到空槽
+        lightdb::frame_id_t frame_id = lightdb::INVALID_FRAME_ID;
+        CHECK(!table.Find(lightdb::INVALID_PAGE_ID, &frame_id));
+        CHECK(!table.Erase(lightdb::INVALID_PAGE_ID));
+        CHECK(!table.Erase(lightdb::INVALID_PAGE_ID));
+        CheckSame(table, expected, keys);
+        // 删掉一项后腾出的位置也不能被 INVALID_PAGE_ID 占用
+        CHECK(table.Erase(keys[0]));
+        expected.erase(keys[0]);
+        CHECK(!table.Insert(lightdb::INVALID_PAGE_ID, 0));
+        CheckSame(table, expected, keys);
+        CHECK(table.Insert(keys[0], 0));
+        expected[keys[0]] = 0;
+        CHECK(!table.Insert(lightdb::MakePageID(4, 0), 0)); //已满
+        CheckSame(table, expected, keys);
+    }
+}
+
+int main() {
+    TestRandomOps();
+    TestInvalidPageId();
+    return TEST_RESULT();
+}
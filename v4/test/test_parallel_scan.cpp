@@ -0,0 +1,114 @@
+// HeapFile::ParallelScan：不同线程数、工作单元大小下（包括页数少于一个工作单元的表和空表），
+// 带或不带过滤条件的结果都必须与单线程游标扫描逐条一致（RID 与数据），两种存储模式都检查
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+#include "test_util.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "test_parallel_scan.db";
+    const char* SMALL_TABLE_FILE = "test_parallel_scan_small.db";
+    const char* EMPTY_TABLE_FILE = "test_parallel_scan_empty.db";
+
+    bool Matches(std::string_view data) {
+        return data[0] == 'a' || data[0] == 'q';
+    }
+
+    std::vector<lightdb::Record> CursorScan(lightdb::HeapFile* table, bool filtered) {
+        std::vector<lightdb::Record> records;
+        lightdb::TableIterator it = table->Scan();
+        lightdb::RecordRef ref;
+        while (it.NextRef(&ref)) {
+            if (!filtered || Matches(ref.GetData())) {
+                records.push_back(ref.ToRecord());
+            }
+        }
+        return records;
+    }
+
+    bool SameRecords(const std::vector<lightdb::Record>& a, const std::vector<lightdb::Record>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            if (!(a[i].rid == b[i].rid) || a[i].data != b[i].data) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void CheckAgainstCursor(lightdb::HeapFile* table, const std::vector<int>& morsels) {
+        auto predicate = [](const lightdb::RecordRef& ref) { return Matches(ref.GetData()); };
+        std::vector<lightdb::Record> all = CursorScan(table, false);
+        std::vector<lightdb::Record> filtered = CursorScan(table, true);
+        for (int threads : {1, 2, 3, 4, 8}) {
+            for (int morsel_pages : morsels) {
+                bool same_all = SameRecords(table->ParallelScan(nullptr, threads, morsel_pages), all);
+                bool same_filtered = SameRecords(table->ParallelScan(predicate, threads, morsel_pages), filtered);
+                if (!same_all || !same_filtered) {
+                    std::fprintf(stderr, "mismatch with %d threads, %d-page morsels\n", threads, morsel_pages);
+                }
+                CHECK(same_all);
+                CHECK(same_filtered);
+            }
+        }
+    }
+
+    // 插入 num_records 条长度不一的记录，再删掉每 7 条中的一条，让页内留下已删除的槽
+    void Fill(lightdb::HeapFile* table, int num_records) {
+        std::vector<lightdb::RID> rids;
+        for (int i = 0; i < num_records; i++) {
+            lightdb::Record record;
+            record.data = std::string(20 + i % 180, static_cast<char>('a' + i % 26));
+            rids.push_back(table->InsertRecord(record));
+            CHECK(rids.back().page_id != lightdb::INVALID_PAGE_ID);
+        }
+        for (int i = 0; i < num_records; i += 7) {
+            CHECK(table->DeleteRecord(rids[i]));
+        }
+    }
+}
+
+int main() {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    for (const char* path : {TABLE_FILE, SMALL_TABLE_FILE, EMPTY_TABLE_FILE}) {
+        lightdb::RemoveTestFiles(path);
+    }
+    const std::vector<int> morsels = {1, 3, 7, 64, 1000};
+    {
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(1024, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        Fill(&table, 20000);
+        CHECK(table.ParallelScan(nullptr, 4, 1).size() == 20000 - (20000 + 6) / 7);
+        CheckAgainstCursor(&table, morsels);
+
+        // 页数少于一个工作单元
+        lightdb::HeapFile small(SMALL_TABLE_FILE, &pool);
+        Fill(&small, 30);
+        CHECK(small.ParallelScan(nullptr, 8, 64).size() == 30 - 5);
+        CheckAgainstCursor(&small, morsels);
+
+        lightdb::HeapFile empty(EMPTY_TABLE_FILE, &pool);
+        CHECK(empty.ParallelScan(nullptr, 4, 64).empty());
+        CHECK(empty.ParallelScan(nullptr, 0, 0).empty());
+    }
+    {
+        // 缓冲池析构时已刷盘，只读映射模式下重新打开
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(64, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool, lightdb::StorageMode::MMAP_READ_ONLY);
+        CHECK(table.GetStorageMode() == lightdb::StorageMode::MMAP_READ_ONLY);
+        CheckAgainstCursor(&table, morsels);
+        // 小缓冲池限制线程数，结果仍须一致
+        lightdb::HeapFile pooled(TABLE_FILE, &pool);
+        CheckAgainstCursor(&pooled, morsels);
+    }
+    for (const char* path : {TABLE_FILE, SMALL_TABLE_FILE, EMPTY_TABLE_FILE}) {
+        lightdb::RemoveTestFiles(path);
+    }
+    return TEST_RESULT();
+}
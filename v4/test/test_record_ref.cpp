@@ -0,0 +1,158 @@
+// 记录引用：ReadRecordRef 返回的引用持有页的 pin 和读闩，存活期间页不会被换出、不能被修改（并发的删除
+// 要等引用释放），移动后仍然有效，释放后页可以加写闩；TableIterator::NextRef 的引用只在下一次 NextRef
+// 之前有效，拷贝出的记录不受影响；映射模式下的引用在表打开期间有效
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "test_record_ref.db";
+    const char* OTHER_FILE = "test_record_ref_other.db";
+    const int POOL_FRAMES = 16;
+    const int NUM_RECORDS = 2000; //约 50 页，多于缓冲池的帧数
+    const int TIMEOUT_MS = 5000;
+
+    std::string MakeData(int i) {
+        return std::to_string(i) + ":" + std::string(100, static_cast<char>('a' + i % 26));
+    }
+
+    bool CanLatchExclusive(lightdb::BufferPool* pool, lightdb::PageID page_id) {
+        bool latched = false;
+        std::thread([&]() {
+            lightdb::Page* page = pool->FetchPage(page_id);
+            if (page == nullptr) {
+                return;
+            }
+            latched = page->latch.try_lock();
+            if (latched) {
+                page->latch.unlock();
+            }
+            pool->UnpinPage(page_id, false);
+        }).join();
+        return latched;
+    }
+
+    // 读遍另一个文件中远多于帧数的页，让缓冲池中未被 pin 住的帧全部换出
+    void ChurnPool(lightdb::BufferPool* pool, lightdb::FileID other_file) {
+        for (int32_t page_no = 0; page_no < 10 * POOL_FRAMES; page_no++) {
+            lightdb::ReadPageGuard guard = pool->FetchPageRead(lightdb::MakePageID(other_file, page_no));
+            CHECK(guard);
+        }
+    }
+
+    void TestPointLookup(lightdb::HeapFile* table, lightdb::BufferPool* pool, lightdb::FileID other_file,
+                         const std::vector<lightdb::RID>& rids) {
+        lightdb::RecordRef ref = table->ReadRecordRef(rids[100]);
+        CHECK(ref);
+        CHECK(ref.GetRID() == rids[100]);
+        CHECK(ref.GetData() == MakeData(100));
+        const char* address = ref.GetData().data();
+        // 引用存活期间页被 pin 住：缓冲池被其他页冲刷后数据仍在原处
+        ChurnPool(pool, other_file);
+        CHECK(ref.GetData().data() == address);
+        CHECK(ref.GetData() == MakeData(100));
+        CHECK(!CanLatchExclusive(pool, rids[100].page_id));
+
+        // 移动后由新的引用持有 pin 和读闩
+        lightdb::RecordRef moved = std::move(ref);
+        CHECK(moved && moved.GetData() == MakeData(100));
+        lightdb::Record copy = moved.ToRecord();
+        CHECK(!CanLatchExclusive(pool, rids[100].page_id));
+
+        // 并发的删除要等引用释放
+        std::atomic<bool> deleted{false};
+        std::thread deleter([&]() {
+            CHECK(table->DeleteRecord(rids[100]));
+            deleted = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        CHECK(!deleted);
+        CHECK(moved.GetData() == MakeData(100));
+        moved = lightdb::RecordRef();
+        lightdb::RunWithTimeout("DeleteRecord after the reference was released", TIMEOUT_MS,
+                                [&]() { deleter.join(); });
+        CHECK(deleted);
+        CHECK(CanLatchExclusive(pool, rids[100].page_id));
+        // 拷贝出的记录不受删除影响
+        CHECK(copy.rid == rids[100] && copy.data == MakeData(100));
+
+        // 已删除或不存在的记录返回空引用，不持有页
+        lightdb::RecordRef missing = table->ReadRecordRef(rids[100]);
+        CHECK(!missing && missing.GetData().empty());
+        CHECK(CanLatchExclusive(pool, rids[100].page_id));
+        CHECK(!table->ReadRecordRef(lightdb::RID(rids[0].page_id, 1000)));
+        CHECK(CanLatchExclusive(pool, rids[0].page_id));
+    }
+
+    void TestScanRefs(lightdb::HeapFile* table, lightdb::BufferPool* pool, int deleted) {
+        lightdb::PageID last_page = lightdb::INVALID_PAGE_ID;
+        std::vector<lightdb::Record> copies;
+        {
+            lightdb::TableIterator it = table->Scan();
+            lightdb::RecordRef ref;
+            while (it.NextRef(&ref)) {
+                CHECK(ref);
+                int i = std::stoi(std::string(ref.GetData().substr(0, ref.GetData().find(':'))));
+                CHECK(ref.GetData() == MakeData(i));
+                copies.push_back(ref.ToRecord());
+                last_page = ref.GetRID().page_id;
+            }
+            // 扫描结束时引用被置空，游标也已放开最后一页
+            CHECK(!ref);
+            CHECK(CanLatchExclusive(pool, last_page));
+        }
+        CHECK(copies.size() == static_cast<size_t>(NUM_RECORDS - deleted));
+        // 每次 NextRef 之后引用就指向下一条，之前拷贝出的记录都还在
+        for (const lightdb::Record& record : copies) {
+            int i = std::stoi(record.data.substr(0, record.data.find(':')));
+            CHECK(record.data == MakeData(i));
+            CHECK(table->ReadRecord(record.rid).data == record.data);
+        }
+    }
+
+    void TestMappedRefs(const std::vector<lightdb::RID>& rids) {
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(POOL_FRAMES, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool, lightdb::StorageMode::MMAP_READ_ONLY);
+        std::vector<lightdb::RecordRef> refs;
+        for (int i = 0; i < NUM_RECORDS; i += 97) {
+            refs.push_back(table.ReadRecordRef(rids[i]));
+        }
+        // 映射模式的引用不占用缓冲池，全部同时存活
+        for (size_t k = 0; k < refs.size(); k++) {
+            int i = static_cast<int>(k) * 97;
+            CHECK(refs[k] && refs[k].GetData() == MakeData(i));
+        }
+        CHECK(!table.ReadRecordRef(rids[100])); //已删除
+    }
+}
+
+int main() {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    lightdb::RemoveTestFiles(TABLE_FILE);
+    lightdb::RemoveTestFiles(OTHER_FILE);
+    std::vector<lightdb::RID> rids;
+    {
+        lightdb::DiskManager dm;
+        lightdb::BufferPool pool(POOL_FRAMES, &dm);
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        for (int i = 0; i < NUM_RECORDS; i++) {
+            lightdb::Record record;
+            record.data = MakeData(i);
+            rids.push_back(table.InsertRecord(record));
+            CHECK(rids.back().page_id != lightdb::INVALID_PAGE_ID);
+        }
+        lightdb::FileID other_file = dm.OpenFile(OTHER_FILE);
+        TestPointLookup(&table, &pool, other_file, rids);
+        TestScanRefs(&table, &pool, 1);
+    }
+    TestMappedRefs(rids);
+    lightdb::RemoveTestFiles(TABLE_FILE);
+    lightdb::RemoveTestFiles(OTHER_FILE);
+    return TEST_RESULT();
+}
@@ -0,0 +1,150 @@
+// 表扫描游标：中途放弃的游标（NextRef 持有页的读闩、Next 留下一批 pin 住的页）析构时释放读闩、
+// 所有 pin 和表的共享锁；游标存活期间切换缓冲池须等待，游标析构后才能完成
+#include "lightdb/buffer_pool_manager.h"
+#include "lightdb/heap_file.h"
+#include "lightdb/logger.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* TABLE_FILE = "test_table_iterator.db";
+    const char* OTHER_FILE = "test_table_iterator_other.db";
+    const int POOL_FRAMES = 64;
+    const int NUM_RECORDS = 8000; //约 200 页，远多于缓冲池的帧数
+    const int TIMEOUT_MS = 5000;
+
+    lightdb::BufferPoolConfig PoolConfig() {
+        lightdb::BufferPoolConfig config;
+        config.frame_wait_timeout_ms = 100; //帧被泄漏的 pin 占住时很快失败
+        return config;
+    }
+
+    // 同时 pin 住另一个文件中与帧数相同的页：只有没有任何帧被遗留的 pin 占住时才能全部取到
+    void CheckAllFramesFree(lightdb::BufferPool* pool, lightdb::FileID other_file) {
+        std::vector<lightdb::PageID> pinned;
+        for (int32_t page_no = 0; page_no < POOL_FRAMES; page_no++) {
+            lightdb::PageID page_id = lightdb::MakePageID(other_file, page_no);
+            if (pool->FetchPage(page_id) == nullptr) {
+                break;
+            }
+            pinned.push_back(page_id);
+        }
+        CHECK(pinned.size() == static_cast<size_t>(POOL_FRAMES));
+        for (lightdb::PageID page_id : pinned) {
+            pool->UnpinPage(page_id, false);
+        }
+    }
+
+    // 在另一个线程中尝试对页加写闩，返回是否立即成功
+    bool CanLatchExclusive(lightdb::BufferPool* pool, lightdb::PageID page_id) {
+        bool latched = false;
+        std::thread([&]() {
+            lightdb::Page* page = pool->FetchPage(page_id);
+            if (page == nullptr) {
+                return;
+            }
+            latched = page->latch.try_lock();
+            if (latched) {
+                page->latch.unlock();
+            }
+            pool->UnpinPage(page_id, false);
+        }).join();
+        return latched;
+    }
+
+    void TestAbandonAfterNextRef(lightdb::HeapFile* table, lightdb::BufferPool* pool, lightdb::FileID other_file) {
+        for (int stop_after : {1, 10, 100, 1000}) {
+            lightdb::PageID page_id = lightdb::INVALID_PAGE_ID;
+            {
+                lightdb::TableIterator it = table->Scan();
+                lightdb::RecordRef ref;
+                for (int i = 0; i < stop_after; i++) {
+                    CHECK(it.NextRef(&ref));
+                }
+                page_id = ref.GetRID().page_id;
+                CHECK(!CanLatchExclusive(pool, page_id)); //借用游标的读闩
+            }
+            CHECK(CanLatchExclusive(pool, page_id));
+            lightdb::RunWithTimeout("FetchPageWrite after an abandoned NextRef scan", TIMEOUT_MS, [&]() {
+                lightdb::WritePageGuard guard = pool->FetchPageWrite(page_id);
+                CHECK(guard);
+            });
+            CheckAllFramesFree(pool, other_file);
+        }
+    }
+
+    void TestAbandonAfterNext(lightdb::HeapFile* table, lightdb::BufferPool* pool, lightdb::FileID other_file) {
+        // 在一批页的中间、批的边界和靠近结尾处放弃，游标各自只 pin 住当前一批
+        for (int stop_after : {1, 37, 600, 1234, NUM_RECORDS - 1}) {
+            lightdb::TableIterator it = table->Scan();
+            lightdb::Record record;
+            for (int i = 0; i < stop_after; i++) {
+                CHECK(it.Next(&record));
+            }
+        }
+        // 按页号范围扫描的游标也一样
+        for (int32_t begin : {0, 5, 50}) {
+            lightdb::TableIterator it = table->Scan(begin, begin + 40);
+            lightdb::Record record;
+            CHECK(it.Next(&record));
+            CHECK(lightdb::GetPageNo(record.rid.page_id) == begin);
+        }
+        CheckAllFramesFree(pool, other_file);
+    }
+
+    void TestPoolLatchReleased(lightdb::HeapFile* table, lightdb::BufferPool* pool, lightdb::BufferPool* other_pool) {
+        auto it = std::make_unique<lightdb::TableIterator>(table->Scan());
+        lightdb::RecordRef ref;
+        CHECK(it->NextRef(&ref));
+        std::atomic<bool> switched{false};
+        std::thread switcher([&]() {
+            CHECK(table->SetBufferPool(other_pool));
+            switched = true;
+        });
+        // 游标持有表的共享锁，切换须等它结束
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        CHECK(!switched);
+        ref = lightdb::RecordRef();
+        it.reset();
+        lightdb::RunWithTimeout("SetBufferPool after the scan was abandoned", TIMEOUT_MS, [&]() { switcher.join(); });
+        CHECK(switched);
+        CHECK(table->GetBufferPool() == other_pool);
+        CHECK(table->SeqScan().size() == static_cast<size_t>(NUM_RECORDS));
+        lightdb::RunWithTimeout("SetBufferPool back", TIMEOUT_MS, [&]() { CHECK(table->SetBufferPool(pool)); });
+    }
+}
+
+int main() {
+    lightdb::Logger::GetInstance().SetLogLevel(lightdb::LogLevel::ERROR);
+    lightdb::RemoveTestFiles(TABLE_FILE);
+    lightdb::RemoveTestFiles(OTHER_FILE);
+    {
+        lightdb::DiskManager dm;
+        lightdb::BufferPoolManager pools(&dm);
+        lightdb::BufferPool& pool = *pools.CreatePool("scan", POOL_FRAMES, PoolConfig());
+        lightdb::BufferPool& other_pool = *pools.CreatePool("other", POOL_FRAMES, PoolConfig());
+        lightdb::HeapFile table(TABLE_FILE, &pool);
+        for (int i = 0; i < NUM_RECORDS; i++) {
+            lightdb::Record record;
+            record.data = std::string(100, static_cast<char>('a' + i % 26));
+            CHECK(table.InsertRecord(record).page_id != lightdb::INVALID_PAGE_ID);
+        }
+        lightdb::FileID other_file = dm.OpenFile(OTHER_FILE);
+        CHECK(other_file != lightdb::INVALID_FILE_ID);
+
+        TestAbandonAfterNextRef(&table, &pool, other_file);
+        TestAbandonAfterNext(&table, &pool, other_file);
+        TestPoolLatchReleased(&table, &pool, &other_pool);
+        CheckAllFramesFree(&pool, other_file);
+        CheckAllFramesFree(&other_pool, other_file);
+        CHECK(table.SeqScan().size() == static_cast<size_t>(NUM_RECORDS));
+    }
+    lightdb::RemoveTestFiles(TABLE_FILE);
+    lightdb::RemoveTestFiles(OTHER_FILE);
+    return TEST_RESULT();
+}
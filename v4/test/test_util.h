@@ -0,0 +1,54 @@
+#ifndef LIGHTDB_TEST_UTIL_H
+#define LIGHTDB_TEST_UTIL_H
+// 测试程序共用的检查宏：条件不成立时打印位置并记一次失败，测试继续执行；
+// main 最后返回 TEST_RESULT()，有失败时为 1，ctest 据此判定
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace lightdb {
+    inline std::atomic<int>& TestFailures() {
+        static std::atomic<int> failures{0}; //检查可能在多个线程中执行
+        return failures;
+    }
+
+    // 删除测试用的表文件及其旁路文件（.fsm、.pmap）
+    inline void RemoveTestFiles(const std::string& path) {
+        std::remove(path.c_str());
+        std::remove((path + ".fsm").c_str());
+        std::remove((path + ".pmap").c_str());
+    }
+
+    // 在另一个线程中执行 fn 并等待；timeout_ms 内没有完成（如在泄漏的闩或锁上等待）时报告失败并立即退出，
+    // 测试不会挂起
+    template <typename Fn>
+    void RunWithTimeout(const char* what, int timeout_ms, Fn fn) {
+        std::promise<void> done;
+        std::future<void> finished = done.get_future();
+        std::thread worker([&]() {
+            fn();
+            done.set_value();
+        });
+        if (finished.wait_for(std::chrono::milliseconds(timeout_ms)) != std::future_status::ready) {
+            std::fprintf(stderr, "%s did not finish within %d ms\n", what, timeout_ms);
+            std::_Exit(1);
+        }
+        worker.join();
+    }
+}
+
+#define CHECK(cond)                                                                        \
+    do {                                                                                   \
+        if (!(cond)) {                                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            lightdb::TestFailures()++;                                                     \
+        }                                                                                  \
+    } while (0)
+
+#define TEST_RESULT() (lightdb::TestFailures() == 0 ? 0 : 1)
+
+#endif